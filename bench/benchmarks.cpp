@@ -0,0 +1,566 @@
+#include <array>          // std::array
+#include <chrono>         // steady_clock
+#include <condition_variable> // std::condition_variable
+#include <iostream>       // cout, endl
+#include <list>           // std::list
+#include <mutex>          // std::mutex
+#include <queue>          // std::queue
+#include <sstream>        // std::ostringstream
+#include <random>         // mt19937
+#include <string>         // std::string
+#include <thread>         // std::thread
+#include <unordered_map>  // std::unordered_map
+#include <vector>         // std::vector
+#include "lru_cache.h"
+#include "channel.h"
+#include "thread_caching_allocator.h"
+#include "vector.h"
+#include "forward_list.h"
+#include "list_format.h"
+#include "perf_scope.h"
+#include "list_pool.h"
+#include "compressed_list.h"
+
+// Keeps the optimizer from dropping the work being measured.
+static volatile size_t sink;
+
+// Hardware counts of the last time_ms() run, printed by the next report().
+static sc::perf_counts last_counts;
+
+/// Runs f once and returns the elapsed time in milliseconds. Counts its hardware events on the way.
+template < typename F >
+double time_ms( F f )
+{
+    sc::perf_scope counters;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+    last_counts = counters.read();
+    return ms;
+}
+
+/// Prints one benchmark line, with the time per operation in nanoseconds, then the
+/// hardware events of the last time_ms() run per operation when the counters work.
+void report( const char * name, double ms, size_t ops )
+{
+    std::cout << "    " << name << ": " << ms << " ms (" << ms * 1e6 / ops << " ns/op)\n";
+    sc::perf_scope::report( std::cout, "  per op", last_counts, ops );
+    last_counts = sc::perf_counts{};
+}
+
+/// The usual LRU cache: std::list in recency order plus an index of its iterators.
+template < typename K, typename V >
+class std_lru_cache
+{
+    std::list< std::pair< K, V > > entries;
+    std::unordered_map< K, typename std::list< std::pair< K, V > >::iterator > index;
+    size_t capacity;
+
+public:
+    explicit std_lru_cache( size_t capacity ) : capacity{ capacity } {}
+
+    V * get( const K & key )
+    {
+        auto found = index.find( key );
+        if ( found == index.end() )
+            return nullptr;
+        entries.splice( entries.end(), entries, found->second );
+        return &found->second->second;
+    }
+
+    void put( const K & key, const V & value )
+    {
+        auto found = index.find( key );
+        if ( found != index.end() )
+        {
+            found->second->second = value;
+            entries.splice( entries.end(), entries, found->second );
+            return;
+        }
+        entries.emplace_back( key, value );
+        index.emplace( key, std::prev( entries.end() ) );
+        if ( entries.size() > capacity )
+        {
+            index.erase( entries.front().first );
+            entries.pop_front();
+        }
+    }
+};
+
+/// Mixed get/put workload: 80% of the lookups go to a hot fifth of the keys.
+template < typename Cache >
+void lru_workload( Cache & cache, const std::vector< int > & keys )
+{
+    size_t found = 0;
+    for ( auto key : keys )
+    {
+        if ( cache.get( key ) != nullptr )
+            found++;
+        else
+            cache.put( key, key );
+    }
+    sink = found;
+}
+
+/// Plain 64 byte record, trivially copyable and destructible.
+struct pod64
+{
+    long fields[8];
+};
+
+/// Copy construction, copy assignment, push_back and clear of a list of n copies of value.
+template < typename List, typename T >
+void copy_workload( const char * name, const T & value, size_t n )
+{
+    std::cout << "  " << name << ", " << n << " elements\n";
+
+    List source;
+    report( "push_back", time_ms( [&]() { for ( size_t i = 0 ; i < n ; ++i ) source.push_back( value ); } ), n );
+
+    double ms = time_ms( [&]() { List copy( source ); sink = copy.size(); } );
+    report( "copy constructor (+ destructor)", ms, n );
+
+    List target;
+    for ( size_t i = 0 ; i < n ; ++i )
+        target.push_back( value );
+    report( "operator= over existing nodes", time_ms( [&]() { target = source; } ), n );
+
+    report( "clear", time_ms( [&]() { target.clear(); } ), n );
+}
+
+/// Pushes n integers into ch, then closes it.
+sc::detached_task bench_produce( sc::channel< int > & ch, size_t n )
+{
+    for ( size_t i = 0 ; i < n ; ++i )
+        co_await ch.push( static_cast< int >( i ) );
+    ch.close();
+}
+
+/// Pops from ch, batch values at a time (one by one when batch is 0), until it is closed.
+sc::detached_task bench_consume( sc::channel< int > & ch, size_t batch )
+{
+    size_t total = 0;
+    if ( batch == 0 )
+    {
+        while ( auto value = co_await ch.pop() )
+            total += *value;
+    }
+    else
+    {
+        while ( true )
+        {
+            auto values = co_await ch.pop_many( batch );
+            if ( values.empty() )
+                break;
+            for ( auto it = values.begin() ; it != values.end() ; ++it )
+                total += *it;
+        }
+    }
+    sink = total;
+}
+
+/// The usual hand-off between threads: a queue, a mutex and one wakeup per item.
+void condvar_workload( size_t n )
+{
+    std::queue< int > queue;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool done = false;
+
+    std::thread consumer( [&]() {
+        size_t total = 0;
+        std::unique_lock< std::mutex > lock( mutex );
+        while ( true )
+        {
+            ready.wait( lock, [&]() { return done or not queue.empty(); } );
+            if ( queue.empty() )
+                break;
+            total += queue.front();
+            queue.pop();
+        }
+        sink = total;
+    } );
+
+    for ( size_t i = 0 ; i < n ; ++i )
+    {
+        {
+            std::lock_guard< std::mutex > lock( mutex );
+            queue.push( static_cast< int >( i ) );
+        }
+        ready.notify_one();
+    }
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        done = true;
+    }
+    ready.notify_one();
+    consumer.join();
+}
+
+/// Every thread builds and destroys its own lists of n elements, rounds times. Returns the elapsed milliseconds.
+template < typename List >
+double churn_workload( size_t threads, size_t rounds, size_t n )
+{
+    return time_ms( [&]() {
+        std::vector< std::thread > workers;
+        for ( size_t t = 0 ; t < threads ; ++t )
+            workers.emplace_back( [&]() {
+                size_t total = 0;
+                for ( size_t r = 0 ; r < rounds ; ++r )
+                {
+                    List seq;
+                    for ( size_t i = 0 ; i < n ; ++i )
+                        seq.push_back( static_cast< long >( i ) );
+                    total += seq.size();
+                }
+                sink = total;
+            } );
+        for ( auto & worker : workers )
+            worker.join();
+    } );
+}
+
+/// Fills a Seq with n ints, then sums it in order and at indices 0, stride, 2 * stride...
+template < typename Seq >
+void access_workload( const char * name, size_t n, size_t stride )
+{
+    Seq seq;
+    report( ( std::string( name ) + ", push_back" ).c_str(), time_ms( [&]() {
+        for ( size_t i = 0 ; i < n ; ++i )
+            seq.push_back( static_cast< int >( i ) );
+    } ), n );
+    report( ( std::string( name ) + ", iterate" ).c_str(), time_ms( [&]() {
+        long sum = 0;
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            sum += *it;
+        sink = sum;
+    } ), n );
+    report( ( std::string( name ) + ", operator[]" ).c_str(), time_ms( [&]() {
+        long sum = 0;
+        for ( size_t i = 0 ; i < n ; i += stride )
+            sum += seq[i];
+        sink = sum;
+    } ), n / stride );
+}
+
+/// Uses a Queue as a FIFO of about depth ints: n push_back() and pop_front(), then one walk.
+template < typename Queue >
+void queue_workload( const char * name, size_t n, size_t depth )
+{
+    report( name, time_ms( [&]() {
+        Queue queue;
+        for ( size_t i = 0 ; i < depth ; ++i )
+            queue.push_back( static_cast< int >( i ) );
+        long sum = 0;
+        for ( size_t i = 0 ; i < n ; ++i )
+        {
+            sum += queue.front();
+            queue.pop_front();
+            queue.push_back( static_cast< int >( i ) );
+        }
+        for ( auto it = queue.begin() ; it != queue.end() ; ++it )
+            sum += *it;
+        sink = sum;
+    } ), n );
+}
+
+/// Walks a list of n elements of 256 bytes through its links only, then reading one byte per element.
+template < typename Layout >
+void layout_workload( const char * name, size_t n )
+{
+    typedef std::array< char, 256 > payload;
+    sc::list< payload, std::allocator< payload >, Layout > seq( n );
+    report( ( std::string( name ) + ", links only" ).c_str(), time_ms( [&]() {
+        size_t count = 0;
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            count++;
+        sink = count;
+    } ), n );
+    report( ( std::string( name ) + ", one byte per element" ).c_str(), time_ms( [&]() {
+        size_t sum = 0;
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            sum += ( *it )[0];
+        sink = sum;
+    } ), n );
+}
+
+/// Builds lists short adjacency lists of degree targets each in round-robin order, sums them all, then drops them.
+/// Times each step and prints the bytes held per element.
+void pool_workload( size_t lists, size_t degree )
+{
+    const size_t n = lists * degree;
+    {
+        std::vector< sc::list< int > > adj;
+        report( "sc::list per list, build", time_ms( [&]() {
+            adj.resize( lists );
+            for ( size_t i = 0 ; i < n ; ++i )
+                adj[i % lists].push_back( static_cast< int >( i ) );
+        } ), n );
+        report( "sc::list per list, sum", time_ms( [&]() {
+            long total = 0;
+            for ( const auto & seq : adj )
+                for ( int x : seq )
+                    total += x;
+            sink = total;
+        } ), n );
+        report( "sc::list per list, destroy", time_ms( [&]() { std::vector< sc::list< int > >().swap( adj ); } ), n );
+        const size_t bytes = lists * ( sizeof( sc::list< int > ) + 2 * sc::list< int >::node_bytes ) + n * sc::list< int >::node_bytes;
+        std::cout << "    sc::list per list: " << static_cast< double >( bytes ) / n << " bytes per element, without malloc headers\n";
+    }
+    {
+        sc::list_pool< int > pool;
+        std::vector< sc::list_pool< int >::handle > adj;
+        report( "sc::list_pool, build", time_ms( [&]() {
+            for ( size_t i = 0 ; i < lists ; ++i )
+                adj.push_back( pool.create() );
+            for ( size_t i = 0 ; i < n ; ++i )
+                pool.push_back( adj[i % lists], static_cast< int >( i ) );
+        } ), n );
+        report( "sc::list_pool, sum", time_ms( [&]() {
+            long total = 0;
+            for ( auto h : adj )
+                for ( int x : pool.range( h ) )
+                    total += x;
+            sink = total;
+        } ), n );
+        const size_t bytes = pool.memory_bytes() + adj.capacity() * sizeof( adj[0] );
+        report( "sc::list_pool, bulk clear", time_ms( [&]() { pool.clear(); } ), n );
+        std::cout << "    sc::list_pool: " << static_cast< double >( bytes ) / n << " bytes per element, handles included\n";
+        adj.clear();
+        report( "sc::list_pool, build again", time_ms( [&]() {
+            for ( size_t i = 0 ; i < lists ; ++i )
+                adj.push_back( pool.create() );
+            for ( size_t i = 0 ; i < n ; ++i )
+                pool.push_back( adj[i % lists], static_cast< int >( i ) );
+        } ), n );
+    }
+}
+
+// The benchmark driver. Build it with optimizations and run ./list_bench.
+int main( void )
+{
+    auto n_bench{0};
+
+    {
+        sc::perf_scope probe;
+        if ( not probe.read().any() )
+            std::cout << ">>> No hardware counters (" << probe.error()
+                      << ", see /proc/sys/kernel/perf_event_paranoid), reporting times only.\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": sc::lru_cache vs std::list + std::unordered_map.\n";
+
+        const size_t capacity = 100000;
+        const size_t ops = 5000000;
+        std::mt19937 gen( 42 );
+        std::uniform_int_distribution< int > hot( 0, capacity / 5 );
+        std::uniform_int_distribution< int > cold( 0, 4 * capacity );
+        std::bernoulli_distribution pick_hot( 0.8 );
+
+        std::vector< int > keys( ops );
+        for ( auto & key : keys )
+            key = pick_hot( gen ) ? hot( gen ) : cold( gen );
+
+        sc::lru_cache< int, int > cache( capacity );
+        report( "sc::lru_cache", time_ms( [&]() { lru_workload( cache, keys ); } ), ops );
+        std::cout << "    hits " << cache.stats().hits << ", misses " << cache.stats().misses
+                  << ", evictions " << cache.stats().evictions << "\n";
+
+        std_lru_cache< int, int > baseline( capacity );
+        report( "std::list + std::unordered_map", time_ms( [&]() { lru_workload( baseline, keys ); } ), ops );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": element copies and destruction by element type.\n";
+
+        const size_t n = 2000000;
+        copy_workload< sc::list< int > >( "sc::list<int>", 7, n );
+        copy_workload< std::list< int > >( "std::list<int>", 7, n );
+        copy_workload< sc::list< pod64 > >( "sc::list<pod64>", pod64{ { 1, 2, 3, 4, 5, 6, 7, 8 } }, n );
+        copy_workload< std::list< pod64 > >( "std::list<pod64>", pod64{ { 1, 2, 3, 4, 5, 6, 7, 8 } }, n );
+        copy_workload< sc::list< std::string > >( "sc::list<std::string>", std::string( 40, 'x' ), n );
+        copy_workload< std::list< std::string > >( "std::list<std::string>", std::string( 40, 'x' ), n );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": sc::channel vs std::queue + std::condition_variable.\n";
+
+        const size_t n = 2000000;
+        for ( size_t batch : { size_t{ 0 }, size_t{ 64 }, size_t{ 1024 } } )
+        {
+            double ms = time_ms( [&]() {
+                sc::manual_executor ex;
+                sc::channel< int > ch( ex, 1024 );
+                sc::spawn( ex, bench_produce( ch, n ) );
+                sc::spawn( ex, bench_consume( ch, batch ) );
+                ex.run();
+            } );
+            std::string name = batch == 0 ? std::string( "sc::channel, pop()" ) : "sc::channel, pop_many(" + std::to_string( batch ) + ")";
+            report( name.c_str(), ms, n );
+        }
+        report( "std::queue + condition_variable, 2 threads", time_ms( [&]() { condvar_workload( n ); } ), n );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": per-thread lists, std::allocator vs sc::thread_caching_allocator.\n";
+        std::cout << "    " << std::thread::hardware_concurrency() << " hardware threads, ns/op over the nodes of all the threads\n";
+
+        const size_t rounds = 200;
+        const size_t n = 10000;
+        for ( size_t threads : { size_t{ 1 }, size_t{ 2 }, size_t{ 4 }, size_t{ 8 } } )
+        {
+            std::cout << "  " << threads << " thread(s)\n";
+            report( "std::allocator", churn_workload< sc::list< long > >( threads, rounds, n ), threads * rounds * n );
+            report( "sc::thread_caching_allocator",
+                    churn_workload< sc::list< long, sc::thread_caching_allocator< long > > >( threads, rounds, n ), threads * rounds * n );
+        }
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": the same code on sc::list and sc::vector.\n";
+
+        const size_t n = 1000000;
+        access_workload< sc::list< int > >( "sc::list<int>", n, n / 100 );
+        access_workload< sc::vector< int > >( "sc::vector<int>", n, n / 100 );
+        access_workload< std::vector< int > >( "std::vector<int>", n, n / 100 );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": queues, sc::list vs sc::forward_list.\n";
+
+        const size_t n = 5000000;
+        for ( size_t depth : { size_t{ 64 }, size_t{ 1000000 } } )
+        {
+            std::cout << "  depth " << depth << "\n";
+            queue_workload< sc::list< int > >( "sc::list<int>", n, depth );
+            queue_workload< sc::forward_list< int > >( "sc::forward_list<int>", n, depth );
+        }
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": node layouts, 256 byte elements.\n";
+        std::cout << "    node bytes: data_first " << sc::list< std::array< char, 256 > >::node_bytes
+                  << ", out_of_line " << sc::list< std::array< char, 256 >, std::allocator< std::array< char, 256 > >, sc::out_of_line >::node_bytes << "\n";
+
+        const size_t n = 200000;
+        layout_workload< sc::data_first >( "data_first", n );
+        layout_workload< sc::links_first >( "links_first", n );
+        layout_workload< sc::cache_aligned >( "cache_aligned", n );
+        layout_workload< sc::out_of_line >( "out_of_line", n );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": formatting and parsing, to_chars/from_chars vs streams.\n";
+
+        const size_t n = 2000000;
+        std::mt19937 gen( 7 );
+        std::uniform_int_distribution< int > values( -1000000000, 1000000000 );
+        sc::list< int > seq;
+        for ( size_t i = 0 ; i < n ; ++i )
+            seq.push_back( values( gen ) );
+
+        std::string text;
+        double ms = time_ms( [&]() { sc::format_to( text, seq ); } );
+        const double mb = text.size() / 1e6;
+        std::cout << "    sc::format_to: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        ms = time_ms( [&]() {
+            std::ostringstream os;
+            os << seq;
+            sink = os.str().size();
+        } );
+        std::cout << "    operator<<: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        ms = time_ms( [&]() { sink = sc::parse< int >( text ).size(); } );
+        std::cout << "    sc::parse, new list: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        sc::list< int > reused;
+        reused.reserve( n );
+        ms = time_ms( [&]() {
+            sc::parse_elements( text, reused );
+            sink = reused.size();
+        } );
+        std::cout << "    sc::parse_elements, reserved list: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        ms = time_ms( [&]() { text.clear(); sc::format_to( text, seq ); } );
+        std::cout << "    sc::format_to, reused buffer: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        ms = time_ms( [&]() {
+            std::istringstream is( text );
+            sc::list< int > back;
+            is >> back;
+            sink = back.size();
+        } );
+        std::cout << "    operator>>: " << ms << " ms (" << mb / ms * 1e3 << " MB/s)\n";
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": a million short lists, one sc::list each vs one sc::list_pool.\n";
+
+        pool_workload( 1000000, 4 );
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    {
+        std::cout << ">>> Benchmark #" << ++n_bench << ": sorted IDs, sc::list<uint32_t> vs sc::compressed_list<uint32_t>.\n";
+
+        const size_t n = 4000000;
+        std::mt19937 gen( 11 );
+        std::uniform_int_distribution< uint32_t > gap( 1, 100 );
+        sc::list< uint32_t > plain;
+        sc::compressed_list< uint32_t > packed;
+        uint32_t id = 0;
+        report( "sc::list, push_back", time_ms( [&]() {
+            for ( size_t i = 0 ; i < n ; ++i )
+                plain.push_back( id += gap( gen ) );
+        } ), n );
+        id = 0;
+        gen.seed( 11 );
+        report( "sc::compressed_list, push_back", time_ms( [&]() {
+            for ( size_t i = 0 ; i < n ; ++i )
+                packed.push_back( id += gap( gen ) );
+        } ), n );
+
+        report( "sc::list, iterate", time_ms( [&]() {
+            uint64_t total = 0;
+            for ( uint32_t x : plain )
+                total += x;
+            sink = total;
+        } ), n );
+        report( "sc::compressed_list, iterate", time_ms( [&]() {
+            uint64_t total = 0;
+            for ( uint32_t x : packed )
+                total += x;
+            sink = total;
+        } ), n );
+        report( "sc::compressed_list, for_each", time_ms( [&]() {
+            uint64_t total = 0;
+            packed.for_each( [&total]( uint32_t x ) { total += x; } );
+            sink = total;
+        } ), n );
+        std::cout << "    bytes per element: sc::list " << static_cast< double >( sc::list< uint32_t >::node_bytes )
+                  << ", sc::compressed_list " << static_cast< double >( packed.memory_bytes() ) / n << "\n";
+
+        std::cout << ">>> Done!\n\n";
+    }
+
+    return 0;
+}
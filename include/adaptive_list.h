@@ -0,0 +1,615 @@
+#ifndef ADAPTIVE_LIST_H
+#define ADAPTIVE_LIST_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "list.h"
+#include "vector.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \struct adaptive_stats
+		\brief decisions of an adaptive_list and the operations behind them.
+	*/
+	struct adaptive_stats{
+		size_t to_contiguous; //!< Conversions from nodes to an array.
+		size_t to_linked; //!< Conversions from an array to nodes.
+		size_t elements_moved; //!< Elements carried over by the conversions.
+		size_t structural_ops; //!< Insertions and erasures away from the back, push_front() and pop_front().
+		size_t indexed_ops; //!< Calls to operator[] and at().
+		size_t scans; //!< Calls to begin(), taken as the start of a walk over the elements.
+	};
+
+
+	/*! \class adaptive_list
+    	\brief sc::list that keeps its elements in nodes or in an array, whichever suits the recent operations.
+
+    	Insertions and erasures away from the back are cheap on nodes and cost a shift
+    	of the following elements in an array; indexed access is the other way round.
+    	Every such operation adds to a pressure towards the representation it favours
+    	and operations suiting the current one relieve it. Once the pressure reaches
+    	switch_threshold the elements are moved to the other representation and the
+    	pressure starts from zero again, so a few odd operations in a long run of the
+    	other kind don't make it convert back and forth. Lists smaller than small_size
+    	stay in an array, where every operation is cheap.
+
+    	A conversion invalidates every iterator and reference. It may happen in any
+    	call that inserts or erases elements, in operator[], at() and in the explicit
+    	make_contiguous() and make_linked(). begin() only records the scan it starts,
+    	so it never invalidates the end() it is compared to. stats() tells why and how
+    	often the list converted.
+	*/
+	template< typename T, typename Allocator = std::allocator< T > >
+	class adaptive_list{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+			typedef list< T, Allocator > linked_type; //!< Representation in nodes.
+			typedef vector< T, Allocator > contiguous_type; //!< Representation in an array.
+			static constexpr size_type switch_threshold=32; //!< Pressure that makes the list convert.
+			static constexpr size_type small_size=64; //!< Below it, the array suits every operation.
+			static constexpr size_type op_weight=2; //!< Pressure of a structural or indexed operation.
+			static constexpr size_type scan_weight=1; //!< Pressure of a scan, cheap enough on nodes.
+
+			/// Kinds of operations, by the representation they favour.
+			enum class op_kind{ structural, indexed, scan };
+
+			//=== Attributes
+			linked_type m_list; //!< The elements while linked, empty otherwise.
+			contiguous_type m_vector; //!< The elements while contiguous, empty otherwise.
+			bool m_linked; //!< Representation in use.
+			size_type m_pressure; //!< Pressure towards the other representation.
+			adaptive_stats m_stats; //!< Counters exposed by stats().
+
+			template< bool Const >
+			class my_basic_iterator;
+
+		public:
+			//=== Standard container alias
+			typedef my_basic_iterator< false > my_iterator; //!< Bidirectional iterator.
+			typedef my_basic_iterator< true > my_const_iterator; //!< Read-only bidirectional iterator.
+			typedef T value_type; //!< Type of the elements.
+			typedef T & reference; //!< Reference to an element.
+			typedef const T & const_reference; //!< Read-only reference to an element.
+			typedef my_iterator iterator; //!< Bidirectional iterator.
+			typedef my_const_iterator const_iterator; //!< Read-only bidirectional iterator.
+			typedef Allocator allocator_type; //!< Allocator of both representations.
+
+			//=== Constructors
+			/// Default constructor, starts contiguous.
+			adaptive_list( )
+				: m_linked{false}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			/// Constructor with count value-initialized elements.
+			explicit adaptive_list( size_type count )
+				: m_vector( count ), m_linked{false}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			/// Constructor with the elements of [first; last).
+			template< typename InputIt, typename = typename std::iterator_traits< InputIt >::iterator_category >
+			adaptive_list( InputIt first, InputIt last )
+				: m_vector( first, last ), m_linked{false}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			/// Constructor with the elements of ilist.
+			adaptive_list( std::initializer_list<T> ilist )
+				: m_vector( ilist ), m_linked{false}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			/// Copies other, in the same representation, with fresh counters.
+			adaptive_list( const adaptive_list& other )
+				: m_list( other.m_list ), m_vector( other.m_vector ), m_linked{other.m_linked}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			/// Takes the elements of other, in the same representation, and leaves it empty. Counters start fresh.
+			adaptive_list( adaptive_list&& other )
+				: m_list( std::move( other.m_list ) ), m_vector( std::move( other.m_vector ) ), m_linked{other.m_linked}, m_pressure{0}, m_stats{}
+			{/*empty*/}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item. Records a scan but never converts.
+			my_iterator begin()
+			{
+				record( op_kind::scan );
+				return first();
+			}
+
+			/// Returns an iterator pointing to the end mark.
+			my_iterator end()
+			{ return m_linked ? my_iterator( m_list.end() ) : my_iterator( m_vector.end() ); }
+
+			my_const_iterator begin() const
+			{ return m_linked ? my_const_iterator( m_list.cbegin() ) : my_const_iterator( m_vector.cbegin() ); }
+
+			my_const_iterator end() const
+			{ return m_linked ? my_const_iterator( m_list.cend() ) : my_const_iterator( m_vector.cend() ); }
+
+			my_const_iterator cbegin() const
+			{ return begin(); }
+
+			my_const_iterator cend() const
+			{ return end(); }
+
+			//=== Methods
+			/// Returns the number of elements.
+			size_type size( ) const
+			{ return m_linked ? m_list.size() : m_vector.size(); }
+
+			/// Checks if the list is empty.
+			bool empty( ) const
+			{ return size() == 0; }
+
+			/// Returns true while the elements are in an array.
+			bool is_contiguous( ) const
+			{ return not m_linked; }
+
+			/// Returns the counters of the conversions and of the operations driving them.
+			const adaptive_stats & stats( ) const
+			{ return m_stats; }
+
+			/// Moves the elements to an array now, e.g. before a phase of indexed reads.
+			void make_contiguous( )
+			{
+				if( not m_linked )
+					return;
+
+				m_vector.reserve( m_list.size() );
+				for( auto it = m_list.begin() ; it != m_list.end() ; ++it )
+					m_vector.push_back( std::move( *it ) );
+				m_stats.elements_moved += m_vector.size();
+				m_stats.to_contiguous++;
+
+				m_list.clear();
+				m_list.shrink_to_fit();
+				m_linked = false;
+				m_pressure = 0;
+			}
+
+			/// Moves the elements to nodes now, e.g. before a phase of insertions in the middle.
+			void make_linked( )
+			{
+				if( m_linked )
+					return;
+
+				for( auto it = m_vector.begin() ; it != m_vector.end() ; ++it )
+					m_list.push_back( std::move( *it ) );
+				m_stats.elements_moved += m_list.size();
+				m_stats.to_linked++;
+
+				m_vector.clear();
+				m_vector.shrink_to_fit();
+				m_linked = true;
+				m_pressure = 0;
+			}
+
+			/// Delete all elements, the representation is kept.
+			void clear( )
+			{
+				m_list.clear();
+				m_vector.clear();
+			}
+
+			/// Adds value to the front of the list.
+			void push_front( const T & value )
+			{
+				if( m_linked )
+					m_list.push_front( value );
+				else
+					m_vector.push_front( value );
+
+				if( record( op_kind::structural ) )
+					convert();
+			}
+
+			/// Adds value to the end of the list.
+			void push_back( const T & value )
+			{
+				if( m_linked )
+					m_list.push_back( value );
+				else
+					m_vector.push_back( value );
+			}
+
+			void push_back( T && value )
+			{
+				if( m_linked )
+					m_list.push_back( std::move( value ) );
+				else
+					m_vector.push_back( std::move( value ) );
+			}
+
+			/// Removes the object at the end of the list.
+			void pop_back( )
+			{
+				if( m_linked )
+					m_list.pop_back();
+				else
+					m_vector.pop_back();
+			}
+
+			/// Removes the object at the front of the list.
+			void pop_front( )
+			{
+				if( m_linked )
+					m_list.pop_front();
+				else
+					m_vector.pop_front();
+
+				if( record( op_kind::structural ) )
+					convert();
+			}
+
+			/// Returns the object at the end of the list.
+			const T & back( ) const
+			{ return m_linked ? m_list.back() : m_vector.back(); }
+
+			/// Returns the object at the beginning of the list.
+			const T & front( ) const
+			{ return m_linked ? m_list.front() : m_vector.front(); }
+
+			/// Replaces the content of the list with copies of value.
+			void assign( const T & value )
+			{
+				if( m_linked )
+					m_list.assign( value );
+				else
+					m_vector.assign( value );
+			}
+
+			/// Replaces the contents with the elements of [first; last).
+			template< typename InItr >
+			void assign( InItr first, InItr last )
+			{
+				if( m_linked )
+					m_list.assign( first, last );
+				else
+					m_vector.assign( first, last );
+			}
+
+			/// Replaces the contents with the elements of ilist.
+			void assign( std::initializer_list< T > ilist )
+			{
+				assign( ilist.begin(), ilist.end() );
+			}
+
+			/// Return the object at the index position, like std::vector it doesn't check pos.
+			T & operator[]( size_type pos )
+			{
+				if( record( op_kind::indexed ) )
+					convert();
+
+				return m_linked ? m_list[pos] : m_vector[pos];
+			}
+
+			/// Returns the object at the index pos.
+			T & at( size_type pos )
+			{
+				if( not ( pos < size() ) )
+					throw std::out_of_range("error in at(): out of range");
+
+				return ( *this )[pos];
+			}
+
+			//=== Operators overload
+			/// Replaces the contents with a copy of other's, in other's representation.
+			adaptive_list& operator=( const adaptive_list& other )
+			{
+				if( this != &other )
+				{
+					m_list = other.m_list;
+					m_vector = other.m_vector;
+					m_linked = other.m_linked;
+					m_pressure = 0;
+				}
+
+				return *this;
+			}
+
+			/// Takes the elements of other, in other's representation, and leaves it empty.
+			adaptive_list& operator=( adaptive_list&& other )
+			{
+				if( this != &other )
+				{
+					m_list = std::move( other.m_list );
+					m_vector = std::move( other.m_vector );
+					m_linked = other.m_linked;
+					m_pressure = 0;
+				}
+
+				return *this;
+			}
+
+			/// Replaces the contents with the elements of ilist.
+			adaptive_list& operator=( std::initializer_list<T> ilist )
+			{
+				assign( ilist );
+
+				return *this;
+			}
+
+			/// Checks if the contents are equal, whatever the representations.
+			bool operator==( const adaptive_list& rhs ) const
+			{
+				return size() == rhs.size() and std::equal( begin(), end(), rhs.begin() );
+			}
+
+			/// Checks if the contents are different.
+			bool operator!=( const adaptive_list& rhs ) const
+			{
+				return not( *this == rhs );
+			}
+
+			/// Adds value before pos. Returns an iterator to the inserted element.
+			my_iterator insert( my_iterator pos, const T & value )
+			{
+				bool at_back = pos == end();
+				my_iterator inserted;
+				if( m_linked )
+					inserted = std::prev( m_list.insert( pos.m_node, value ) ); // sc::list returns pos.
+				else
+					inserted = m_vector.insert( pos.m_slot, value );
+
+				return at_back ? inserted : settle( inserted );
+			}
+
+			/// Adds the elements of [first; last) before pos. Returns an iterator to the first inserted element.
+			template< typename InItr >
+			my_iterator insert( my_iterator pos, InItr first, InItr last )
+			{
+				bool at_back = pos == end();
+				my_iterator inserted;
+				if( m_linked )
+				{
+					auto before = std::prev( pos.m_node );
+					m_list.insert( pos.m_node, first, last );
+					inserted = std::next( before );
+				}
+				else
+					inserted = m_vector.insert( pos.m_slot, first, last );
+
+				return at_back ? inserted : settle( inserted );
+			}
+
+			/// Adds the elements of ilist before pos. Returns an iterator to the first inserted element.
+			my_iterator insert( my_iterator pos, std::initializer_list< T > ilist )
+			{
+				return insert( pos, ilist.begin(), ilist.end() );
+			}
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			my_iterator erase( my_iterator pos )
+			{
+				my_iterator next = m_linked ? my_iterator( m_list.erase( pos.m_node ) ) : my_iterator( m_vector.erase( pos.m_slot ) );
+
+				return next == end() ? next : settle( next );
+			}
+
+			/// Removes elements in the range [first; last).
+			my_iterator erase( my_iterator first, my_iterator last )
+			{
+				my_iterator next = m_linked ? my_iterator( m_list.erase( first.m_node, last.m_node ) ) : my_iterator( m_vector.erase( first.m_slot, last.m_slot ) );
+
+				return next == end() ? next : settle( next );
+			}
+
+			/// Removes every element equal to value. Returns the number of removed elements.
+			size_type remove( const T & value )
+			{ return m_linked ? m_list.remove( value ) : m_vector.remove( value ); }
+
+			/// Removes every element for which p returns true. Returns the number of removed elements.
+			template< typename UnaryPredicate >
+			size_type remove_if( UnaryPredicate p )
+			{ return m_linked ? m_list.remove_if( p ) : m_vector.remove_if( p ); }
+
+			/// Removes consecutive duplicates. Returns the number of removed elements.
+			size_type unique( )
+			{ return m_linked ? m_list.unique() : m_vector.unique(); }
+
+			/// Sorts the elements in ascending order, stable.
+			void sort( )
+			{
+				if( m_linked )
+					m_list.sort();
+				else
+					m_vector.sort();
+			}
+
+			/// Sorts the elements by comp, a strict weak ordering. Stable.
+			template< typename Compare >
+			void sort( Compare comp )
+			{
+				if( m_linked )
+					m_list.sort( comp );
+				else
+					m_vector.sort( comp );
+			}
+
+			friend std::ostream& operator<<(std::ostream& os, const adaptive_list& al)
+			{
+				return al.m_linked ? os << al.m_list : os << al.m_vector;
+			}
+
+		private:
+			/// Returns an iterator to the first element without recording a scan.
+			my_iterator first( )
+			{ return m_linked ? my_iterator( m_list.begin() ) : my_iterator( m_vector.begin() ); }
+
+			/// Adds op to the pressure. Returns true when the list should convert.
+			bool record( op_kind op )
+			{
+				bool favours_linked = op == op_kind::structural and size() >= small_size;
+				size_type weight = op == op_kind::scan ? scan_weight : op_weight;
+
+				if( op == op_kind::structural )
+					m_stats.structural_ops++;
+				else if( op == op_kind::indexed )
+					m_stats.indexed_ops++;
+				else
+					m_stats.scans++;
+
+				if( favours_linked != m_linked )
+					m_pressure += weight;
+				else
+					m_pressure = m_pressure > weight ? m_pressure - weight : 0;
+
+				return op != op_kind::scan and m_pressure >= switch_threshold;
+			}
+
+			/// Switches to the other representation.
+			void convert( )
+			{
+				if( m_linked )
+					make_contiguous();
+				else
+					make_linked();
+			}
+
+			/// Records a structural operation which left pos valid, converts if needed and returns pos in the current representation.
+			my_iterator settle( my_iterator pos )
+			{
+				if( not record( op_kind::structural ) )
+					return pos;
+
+				difference_type index = m_linked ? std::distance( m_list.begin(), pos.m_node ) : pos.m_slot - m_vector.begin();
+				convert();
+
+				return std::next( first(), index );
+			}
+
+		/*! \class my_basic_iterator
+
+			Bidirectional iterator over either representation, read-only when Const is set.
+		*/
+		template< bool Const >
+		class my_basic_iterator{
+			private:
+				typedef typename std::conditional< Const, typename linked_type::const_iterator, typename linked_type::iterator >::type node_iterator;
+				typedef typename std::conditional< Const, const T *, T * >::type slot_pointer;
+				typedef my_basic_iterator iterator;
+
+				node_iterator m_node; //!< Position while linked.
+				slot_pointer m_slot; //!< Position while contiguous.
+				bool m_linked; //!< Which of the two is in use.
+
+				friend class adaptive_list;
+				friend class my_basic_iterator< not Const >;
+
+			public:
+				//=== Alias
+				typedef std::bidirectional_iterator_tag iterator_category; //!< The weaker of the two representations.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef typename std::conditional< Const, const T *, T * >::type pointer; //!< Pointer to an element.
+				typedef typename std::conditional< Const, const T &, T & >::type reference; //!< Reference to an element.
+
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				my_basic_iterator()
+					: m_node(), m_slot{nullptr}, m_linked{false}
+				{/*empty*/}
+
+				my_basic_iterator( node_iterator node )
+					: m_node( node ), m_slot{nullptr}, m_linked{true}
+				{/*empty*/}
+
+				my_basic_iterator( slot_pointer slot )
+					: m_node(), m_slot{slot}, m_linked{false}
+				{/*empty*/}
+
+				/// A my_iterator converts to a my_const_iterator.
+				template< bool Other, typename = typename std::enable_if< Const and not Other >::type >
+				my_basic_iterator( const my_basic_iterator< Other > & other )
+					: m_node( other.m_node ), m_slot{other.m_slot}, m_linked{other.m_linked}
+				{/*empty*/}
+
+				//=== Operators
+				iterator & operator++(void)
+				{
+					if( m_linked )
+						++m_node;
+					else
+						++m_slot;
+					return *this;
+				}
+
+				iterator operator++(int)
+				{
+					iterator temp( *this );
+					++*this;
+					return temp;
+				}
+
+				iterator & operator--(void)
+				{
+					if( m_linked )
+						--m_node;
+					else
+						--m_slot;
+					return *this;
+				}
+
+				iterator operator--(int)
+				{
+					iterator temp( *this );
+					--*this;
+					return temp;
+				}
+
+				reference operator*() const
+				{ return m_linked ? *m_node : *m_slot; }
+
+				pointer operator->() const
+				{ return &**this; }
+
+				/// Moves n elements away, O(1) while contiguous, O(n) while linked.
+				friend iterator operator+(iterator it, difference_type n)
+				{
+					if( not it.m_linked )
+						it.m_slot += n;
+					else if( n >= 0 )
+						it.m_node = it.m_node + static_cast< int >( n );
+					else
+						it.m_node = it.m_node - static_cast< int >( -n );
+					return it;
+				}
+
+				friend iterator operator+(difference_type n, iterator it)
+				{ return it + n; }
+
+				friend iterator operator-(iterator it, difference_type n)
+				{ return it + -n; }
+
+				/// Returns the signed number of steps from it2 to it1.
+				friend difference_type operator-(iterator it1, iterator it2)
+				{ return it1.m_linked ? it1.m_node - it2.m_node : it1.m_slot - it2.m_slot; }
+
+				bool operator==( const iterator& it2) const
+				{ return m_linked ? m_node == it2.m_node : m_slot == it2.m_slot; }
+
+				bool operator!=( const iterator& it2) const
+				{ return not( *this == it2 ); }
+		}; // class my_basic_iterator
+
+	}; // class adaptive_list
+
+	/// Erases all the elements of c for which pred returns true. Returns the number of erased elements.
+	template< typename T, typename Allocator, typename Pred >
+	size_t erase_if( adaptive_list< T, Allocator > & c, Pred pred )
+	{
+		return c.remove_if( pred );
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,539 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "list.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class executor
+		\brief runs the coroutines woken up by a channel.
+	*/
+	class executor{
+		public:
+			virtual ~executor( ) = default;
+
+			/// Schedules handle to be resumed.
+			virtual void post( std::coroutine_handle<> handle ) = 0;
+	}; // class executor
+
+
+	/*! \class manual_executor
+		\brief single threaded executor, the posted coroutines run when the owner calls run().
+	*/
+	class manual_executor : public executor{
+		private:
+			std::mutex m_mutex; //!< Guards the ready queue, posting may happen from other threads.
+			std::vector< std::coroutine_handle<> > m_ready; //!< Coroutines waiting to be resumed.
+
+		public:
+			/// Schedules handle to be resumed by the next run().
+			void post( std::coroutine_handle<> handle ) override
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_ready.push_back( handle );
+			}
+
+			/// Resumes the posted coroutines, and the ones they post, until none is left.
+			/// Returns the number of resumptions.
+			size_t run( )
+			{
+				size_t resumed = 0;
+				std::vector< std::coroutine_handle<> > batch;
+				while( true )
+				{
+					{
+						std::lock_guard< std::mutex > lock( m_mutex );
+						batch.swap( m_ready );
+					}
+					if( batch.empty() )
+						return resumed;
+
+					for( std::coroutine_handle<> handle : batch )
+						handle.resume();
+					resumed += batch.size();
+					batch.clear();
+				}
+			}
+	}; // class manual_executor
+
+
+	/*! \class thread_pool_executor
+		\brief executor resuming the posted coroutines on a fixed set of threads.
+	*/
+	class thread_pool_executor : public executor{
+		private:
+			std::mutex m_mutex; //!< Guards the ready queue.
+			std::condition_variable m_wake; //!< Signals new coroutines, or that the pool got idle.
+			list< std::coroutine_handle<> > m_ready; //!< Coroutines waiting to be resumed.
+			size_t m_running; //!< Number of coroutines being resumed right now.
+			bool m_stop; //!< Set when the pool is shutting down.
+			std::vector< std::thread > m_threads; //!< Workers.
+
+			void run( )
+			{
+				std::unique_lock< std::mutex > lock( m_mutex );
+				while( true )
+				{
+					m_wake.wait( lock, [this]{ return m_stop or not m_ready.empty(); } );
+					if( m_ready.empty() )
+						return;
+
+					std::coroutine_handle<> handle = m_ready.front();
+					m_ready.pop_front();
+					m_running++;
+
+					lock.unlock();
+					handle.resume();
+					lock.lock();
+
+					m_running--;
+					if( m_ready.empty() and m_running == 0 )
+						m_wake.notify_all();
+				}
+			}
+
+		public:
+			/// Starts threads workers.
+			explicit thread_pool_executor( size_t threads = std::thread::hardware_concurrency() )
+				: m_running{0}, m_stop{false}
+			{
+				if( threads == 0 )
+					threads = 1;
+				for( size_t i{0u} ; i < threads ; i++ )
+					m_threads.emplace_back( &thread_pool_executor::run, this );
+			}
+
+			thread_pool_executor( const thread_pool_executor& ) = delete;
+			thread_pool_executor& operator=( const thread_pool_executor& ) = delete;
+
+			/// Resumes the pending coroutines and stops the workers.
+			~thread_pool_executor( )
+			{
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					m_stop = true;
+				}
+				m_wake.notify_all();
+				for( std::thread & worker : m_threads )
+					worker.join();
+			}
+
+			/// Schedules handle to be resumed by one of the workers.
+			void post( std::coroutine_handle<> handle ) override
+			{
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					m_ready.push_back( handle );
+				}
+				m_wake.notify_one();
+			}
+
+			/// Blocks until no coroutine is queued or running.
+			void wait_idle( )
+			{
+				std::unique_lock< std::mutex > lock( m_mutex );
+				m_wake.wait( lock, [this]{ return m_ready.empty() and m_running == 0; } );
+			}
+	}; // class thread_pool_executor
+
+
+	/*! \class detached_task
+		\brief coroutine return type for the stages feeding and draining channels.
+
+		The coroutine starts suspended and runs once handed to spawn(); its frame is
+		freed when it returns. A task that is never spawned is destroyed with its object.
+	*/
+	class detached_task{
+		public:
+			struct promise_type{
+				detached_task get_return_object( )
+				{ return detached_task( std::coroutine_handle< promise_type >::from_promise( *this ) ); }
+
+				std::suspend_always initial_suspend( ) noexcept
+				{ return {}; }
+
+				std::suspend_never final_suspend( ) noexcept
+				{ return {}; }
+
+				void return_void( )
+				{/*empty*/}
+
+				void unhandled_exception( )
+				{ std::terminate(); }
+			};
+
+		private:
+			std::coroutine_handle< promise_type > m_handle; //!< Suspended coroutine, null once released.
+
+			explicit detached_task( std::coroutine_handle< promise_type > handle )
+				: m_handle{handle}
+			{/*empty*/}
+
+		public:
+			detached_task( detached_task && other )
+				: m_handle{ std::exchange( other.m_handle, nullptr ) }
+			{/*empty*/}
+
+			detached_task( const detached_task& ) = delete;
+			detached_task& operator=( const detached_task& ) = delete;
+
+			~detached_task( )
+			{
+				if( m_handle )
+					m_handle.destroy();
+			}
+
+			/// Gives up the coroutine, which now owns its frame.
+			std::coroutine_handle<> release( )
+			{ return std::exchange( m_handle, nullptr ); }
+	}; // class detached_task
+
+	/// Starts task on ex.
+	inline void spawn( executor & ex, detached_task task )
+	{ ex.post( task.release() ); }
+
+
+	/*! \class channel
+    	\brief queue between coroutines: co_await push( v ), co_await pop() and co_await pop_many( n ).
+
+    	The buffered values are kept in an sc::list, so pop_many() hands the popped
+    	values over by relinking their nodes instead of copying them, in O(1) when
+    	it takes the whole buffer. A value pushed while a coroutine waits in pop()
+    	goes straight to it. Waiting coroutines are linked through their awaiters,
+    	so suspending never allocates, and are resumed on the channel's executor.
+    	A bounded channel suspends pushers while it holds capacity values; a zero
+    	capacity channel hands every value from a pusher to a popper.
+
+    	All the waiting coroutines must have been resumed before the channel is destroyed.
+	*/
+	template< typename T >
+	class channel{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+
+			//=== Attributes
+			/// A suspended coroutine, linked in a waiting queue.
+			struct Waiter{
+				Waiter * next;
+				std::coroutine_handle<> handle;
+			};
+
+			/// A coroutine suspended in pop() or pop_many(), waiting for values.
+			struct PopWaiter : Waiter{
+				std::optional< T > * item; //!< Where pop() wants its value, or nullptr.
+				list< T > * batch; //!< Where pop_many() wants its values, or nullptr.
+				size_type limit; //!< Most values pop_many() takes.
+			};
+
+			/// A coroutine suspended in push(), waiting for room.
+			struct PushWaiter : Waiter{
+				T * value; //!< Value to push, owned by the awaiter and moved out when the channel takes it.
+				bool pushed; //!< Whether the channel took the value.
+			};
+
+			/// First-in first-out queue of waiters, linked through next.
+			struct WaiterQueue{
+				Waiter * first;
+				Waiter * last;
+
+				bool empty( ) const
+				{ return first == nullptr; }
+
+				void push( Waiter * waiter )
+				{
+					waiter->next = nullptr;
+					if( last == nullptr )
+						first = waiter;
+					else
+						last->next = waiter;
+					last = waiter;
+				}
+
+				Waiter * pop( )
+				{
+					Waiter * waiter = first;
+					first = first->next;
+					if( first == nullptr )
+						last = nullptr;
+					return waiter;
+				}
+			};
+
+			executor & m_executor; //!< Resumes the woken coroutines.
+			size_type m_capacity; //!< Most values buffered at once.
+			std::mutex m_mutex; //!< Guards everything below.
+			list< T > m_items; //!< Buffered values, oldest first.
+			WaiterQueue m_poppers; //!< Coroutines waiting for values.
+			WaiterQueue m_pushers; //!< Coroutines waiting for room.
+			bool m_closed; //!< Set by close().
+
+		public:
+			static constexpr size_type unbounded=std::numeric_limits< size_type >::max(); //!< Capacity of a channel that never blocks pushers.
+
+			/// Awaitable of pop(), yields the value or nothing if the channel is closed and empty.
+			class pop_awaiter{
+				private:
+					channel & m_channel;
+					PopWaiter m_waiter;
+					std::optional< T > m_item;
+
+				public:
+					explicit pop_awaiter( channel & ch )
+						: m_channel( ch ), m_waiter{ { nullptr, nullptr }, &m_item, nullptr, 1 }
+					{/*empty*/}
+
+					// The waiter points into the awaiter, so it stays where co_await created it.
+					pop_awaiter( const pop_awaiter& ) = delete;
+					pop_awaiter& operator=( const pop_awaiter& ) = delete;
+
+					bool await_ready( ) const
+					{ return false; }
+
+					bool await_suspend( std::coroutine_handle<> handle )
+					{ return m_channel.suspend_pop( &m_waiter, handle ); }
+
+					std::optional< T > await_resume( )
+					{ return std::move( m_item ); }
+			};
+
+			/// Awaitable of pop_many(), yields at least one value, or none if the channel is closed and empty.
+			class pop_many_awaiter{
+				private:
+					channel & m_channel;
+					PopWaiter m_waiter;
+					list< T > m_batch;
+
+				public:
+					pop_many_awaiter( channel & ch, size_type limit )
+						: m_channel( ch ), m_waiter{ { nullptr, nullptr }, nullptr, &m_batch, limit }
+					{/*empty*/}
+
+					// The waiter points into the awaiter, so it stays where co_await created it.
+					pop_many_awaiter( const pop_many_awaiter& ) = delete;
+					pop_many_awaiter& operator=( const pop_many_awaiter& ) = delete;
+
+					bool await_ready( ) const
+					{ return false; }
+
+					bool await_suspend( std::coroutine_handle<> handle )
+					{ return m_channel.suspend_pop( &m_waiter, handle ); }
+
+					list< T > await_resume( )
+					{
+						list< T > batch;
+						batch.splice( batch.end(), m_batch );
+						return batch;
+					}
+			};
+
+			/// Awaitable of push(), yields false if the channel was closed before taking the value.
+			class push_awaiter{
+				private:
+					channel & m_channel;
+					PushWaiter m_waiter;
+					T m_value;
+
+				public:
+					push_awaiter( channel & ch, const T & value )
+						: m_channel( ch ), m_waiter{ { nullptr, nullptr }, &m_value, false }, m_value( value )
+					{/*empty*/}
+
+					push_awaiter( channel & ch, T && value )
+						: m_channel( ch ), m_waiter{ { nullptr, nullptr }, &m_value, false }, m_value( std::move( value ) )
+					{/*empty*/}
+
+					// The waiter points into the awaiter, so it stays where co_await created it.
+					push_awaiter( const push_awaiter& ) = delete;
+					push_awaiter& operator=( const push_awaiter& ) = delete;
+
+					bool await_ready( ) const
+					{ return false; }
+
+					bool await_suspend( std::coroutine_handle<> handle )
+					{ return m_channel.suspend_push( &m_waiter, handle ); }
+
+					bool await_resume( ) const
+					{ return m_waiter.pushed; }
+			};
+
+			//=== Constructors
+			/// Channel buffering at most capacity values, resuming its waiters on ex.
+			explicit channel( executor & ex, size_type capacity = unbounded )
+				: m_executor( ex ), m_capacity{capacity}, m_poppers{ nullptr, nullptr }, m_pushers{ nullptr, nullptr }, m_closed{false}
+			{/*empty*/}
+
+			channel( const channel& ) = delete;
+			channel& operator=( const channel& ) = delete;
+
+			//=== Methods
+			/// Returns the number of buffered values.
+			size_type size( )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				return m_items.size();
+			}
+
+			/// Returns the maximum number of buffered values.
+			size_type capacity( ) const
+			{ return m_capacity; }
+
+			/// Waits for room, then pushes value. The value is moved along, from the awaiter to the buffer or
+			/// straight to a waiting popper, and out to the popper again: push( std::move( v ) ) never copies.
+			push_awaiter push( const T & value )
+			{ return push_awaiter( *this, value ); }
+
+			push_awaiter push( T && value )
+			{ return push_awaiter( *this, std::move( value ) ); }
+
+			/// Waits for a value, then pops it.
+			pop_awaiter pop( )
+			{ return pop_awaiter( *this ); }
+
+			/// Waits for a value, then pops up to limit of the buffered values at once. limit must be positive:
+			/// an empty batch means the channel is closed and drained.
+			pop_many_awaiter pop_many( size_type limit )
+			{
+				if( limit == 0 )
+					throw std::invalid_argument("error in pop_many(): limit must be positive");
+				return pop_many_awaiter( *this, limit );
+			}
+
+			/// Stops accepting values and wakes every waiter. The buffered values can still be popped.
+			void close( )
+			{
+				WaiterQueue woken{ nullptr, nullptr };
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					m_closed = true;
+
+					while( not m_poppers.empty() )
+						woken.push( m_poppers.pop() );
+					while( not m_pushers.empty() )
+					{
+						PushWaiter * pusher = static_cast< PushWaiter * >( m_pushers.pop() );
+						pusher->pushed = false;
+						woken.push( pusher );
+					}
+				}
+				resume( woken );
+			}
+
+		private:
+			/// Posts the woken waiters to the executor, in the order they were woken.
+			void resume( WaiterQueue woken )
+			{
+				for( Waiter * waiter = woken.first ; waiter != nullptr ; )
+				{
+					// Read next first: once posted, the waiter may already be gone.
+					Waiter * next = waiter->next;
+					m_executor.post( waiter->handle );
+					waiter = next;
+				}
+			}
+
+			/// Moves value to a suspended popper.
+			static void deliver( PopWaiter * popper, T & value )
+			{
+				if( popper->batch != nullptr )
+					popper->batch->push_back( std::move( value ) );
+				else
+					popper->item->emplace( std::move( value ) );
+			}
+
+			/// Pops for popper, or queues it when there is nothing to pop. Returns true if popper stays suspended.
+			bool suspend_pop( PopWaiter * popper, std::coroutine_handle<> handle )
+			{
+				WaiterQueue woken{ nullptr, nullptr };
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					if( m_items.empty() and m_pushers.empty() and not m_closed )
+					{
+						popper->handle = handle;
+						m_poppers.push( popper );
+						return true;
+					}
+
+					// Without buffer, a waiting pusher hands its value over through it.
+					if( m_items.empty() and not m_pushers.empty() )
+						admit( woken );
+
+					if( popper->batch == nullptr )
+					{
+						if( not m_items.empty() )
+						{
+							popper->item->emplace( std::move( *m_items.begin() ) );
+							m_items.pop_front();
+						}
+					}
+					else if( popper->limit >= m_items.size() )
+						popper->batch->splice( popper->batch->end(), m_items );
+					else
+						popper->batch->splice( popper->batch->end(), m_items, m_items.begin(), m_items.begin() + popper->limit );
+
+					while( not m_pushers.empty() and m_items.size() < m_capacity )
+						admit( woken );
+				}
+				resume( woken );
+				return false;
+			}
+
+			/// Buffers the value of the first waiting pusher and wakes it.
+			void admit( WaiterQueue & woken )
+			{
+				PushWaiter * pusher = static_cast< PushWaiter * >( m_pushers.pop() );
+				m_items.push_back( std::move( *pusher->value ) );
+				pusher->pushed = true;
+				woken.push( pusher );
+			}
+
+			/// Pushes for pusher, or queues it when there is no room. Returns true if pusher stays suspended.
+			bool suspend_push( PushWaiter * pusher, std::coroutine_handle<> handle )
+			{
+				WaiterQueue woken{ nullptr, nullptr };
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					if( m_closed )
+					{
+						pusher->pushed = false;
+						return false;
+					}
+
+					if( not m_poppers.empty() )
+					{
+						PopWaiter * popper = static_cast< PopWaiter * >( m_poppers.pop() );
+						deliver( popper, *pusher->value );
+						woken.push( popper );
+					}
+					else if( m_items.size() < m_capacity )
+						m_items.push_back( std::move( *pusher->value ) );
+					else
+					{
+						pusher->handle = handle;
+						m_pushers.push( pusher );
+						return true;
+					}
+					pusher->pushed = true;
+				}
+				resume( woken );
+				return false;
+			}
+	}; // class channel
+
+} // namespace sc
+
+#endif
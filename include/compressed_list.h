@@ -0,0 +1,657 @@
+#ifndef COMPRESSED_LIST_H
+#define COMPRESSED_LIST_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class compressed_list
+    	\brief list of integers packed in linked blocks of zigzag varint deltas.
+
+    	Each block of 256 bytes keeps its first value as is and every following
+    	value as the difference with the previous one, zigzag encoded (so small
+    	negative steps stay small) and written 7 bits per byte. Sorted or clustered
+    	IDs take one or two bytes each instead of a whole sc::list node.
+
+    	Elements are read-only: the iterators are bidirectional and return values,
+    	decoding on the way. insert() and erase() re-encode one block, splitting it
+    	in two when it overflows, so they cost O(block) after the O(n) walk to the
+    	position. for_each() decodes block by block and is the fastest scan.
+	*/
+	template< typename Int, typename Allocator = std::allocator< Int > >
+	class compressed_list{
+		static_assert( std::is_integral< Int >::value and not std::is_same< Int, bool >::value,
+			"sc::compressed_list holds integers" );
+
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef typename std::make_unsigned< Int >::type unsigned_type; //!< Deltas are computed modulo 2^bits.
+			static constexpr size_type initial_size=0; //!< Default value is 0.
+			static constexpr size_t block_size=256; //!< Bytes per block, header included.
+
+			//=== Attributes
+			struct Block{
+				Block* next;
+				Block* prev;
+				Int first; //!< First value, not encoded.
+				Int last; //!< Last value, for push_back() and backward walks.
+				uint16_t count; //!< Number of values, first included.
+				uint16_t bytes; //!< Bytes of data in use.
+				unsigned char data[block_size - 2 * sizeof( void * ) - 2 * sizeof( Int ) - 2 * sizeof( uint16_t )]; //!< The deltas of the values after first.
+			};
+
+			static constexpr size_t block_bytes=sizeof( Block::data ); //!< Room for deltas per block.
+			static constexpr size_t max_count=block_bytes + 1; //!< Most values a block can hold, one byte per delta.
+
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< Block > block_allocator; //!< Allocates the blocks.
+			typedef std::allocator_traits< block_allocator > block_traits; //!< Interface of block_allocator.
+
+			[[no_unique_address]] block_allocator m_alloc; //!< Source of the blocks.
+			size_type m_size; //!< size of the list.
+			size_type m_blocks; //!< Number of blocks.
+			Block * m_head; //!< First block, nullptr when empty.
+			Block * m_tail; //!< Last block, nullptr when empty.
+
+		public:
+			class my_const_iterator;
+
+			//=== Standard container alias
+			typedef Int value_type; //!< Type of the elements.
+			typedef Int reference; //!< Elements are decoded, read by value.
+			typedef Int const_reference; //!< Elements are decoded, read by value.
+			typedef my_const_iterator iterator; //!< Read-only bidirectional iterator.
+			typedef my_const_iterator const_iterator; //!< Read-only bidirectional iterator.
+			typedef Allocator allocator_type; //!< Allocator the blocks are obtained from, rebound to them.
+
+			//=== Constructors
+			/// Default constructor.
+			compressed_list( )
+				: m_size{initial_size}, m_blocks{0}, m_head{nullptr}, m_tail{nullptr}
+			{/*empty*/}
+
+			/// Empty list allocating its blocks from alloc.
+			explicit compressed_list( const Allocator & alloc )
+				: m_alloc( alloc ), m_size{initial_size}, m_blocks{0}, m_head{nullptr}, m_tail{nullptr}
+			{/*empty*/}
+
+			/// Constructor with elements in [first, last) range.
+			template< typename InputIt, typename = typename std::iterator_traits< InputIt >::iterator_category >
+			compressed_list( InputIt first, InputIt last )
+				: compressed_list()
+			{
+				for( ; first != last ; ++first )
+					push_back( *first );
+			}
+
+			/// std::initializer_list copy constructor.
+			compressed_list( std::initializer_list< Int > ilist )
+				: compressed_list( ilist.begin(), ilist.end() )
+			{/*empty*/}
+
+			/// Copy constructor, copies the blocks as they are.
+			compressed_list( const compressed_list& other )
+				: m_alloc( block_traits::select_on_container_copy_construction( other.m_alloc ) ), m_size{initial_size}, m_blocks{0}, m_head{nullptr}, m_tail{nullptr}
+			{
+				append_blocks( other );
+			}
+
+			/// Move constructor, other is left empty.
+			compressed_list( compressed_list&& other ) noexcept
+				: m_alloc( std::move( other.m_alloc ) ), m_size{other.m_size}, m_blocks{other.m_blocks}, m_head{other.m_head}, m_tail{other.m_tail}
+			{
+				other.m_size = initial_size;
+				other.m_blocks = 0;
+				other.m_head = other.m_tail = nullptr;
+			}
+
+			/// Destructor.
+			~compressed_list( )
+			{
+				clear();
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item in the list.
+			my_const_iterator begin() const
+			{ return m_head == nullptr ? end() : my_const_iterator( this, m_head, 0, 0, m_head->first ); }
+
+			/// Returns a iterator pointing to the position just after the last item in the list.
+			my_const_iterator end() const
+			{ return my_const_iterator( this, nullptr, 0, 0, Int() ); }
+
+			my_const_iterator cbegin() const
+			{ return begin(); }
+
+			my_const_iterator cend() const
+			{ return end(); }
+
+			//=== Methods
+			/// Returns the size of the list.
+			size_type size( ) const
+			{ return m_size; }
+
+			/// Checks if the list is empty.
+			bool empty( ) const
+			{ return m_size == 0; }
+
+			/// Returns the number of blocks.
+			size_type block_count( ) const
+			{ return m_blocks; }
+
+			/// Returns the bytes held by the list, blocks included.
+			size_t memory_bytes( ) const
+			{ return sizeof( *this ) + m_blocks * sizeof( Block ); }
+
+			/// Returns a copy of the allocator.
+			allocator_type get_allocator( ) const
+			{ return allocator_type( m_alloc ); }
+
+			/// Removes all the elements and frees the blocks.
+			void clear( )
+			{
+				while( m_head != nullptr )
+				{
+					Block * target = m_head;
+					m_head = m_head->next;
+					delete_block( target );
+				}
+				m_tail = nullptr;
+				m_blocks = 0;
+				m_size = initial_size;
+			}
+
+			/// Returns the first element.
+			Int front( ) const
+			{ return m_head->first; }
+
+			/// Returns the last element.
+			Int back( ) const
+			{ return m_tail->last; }
+
+			/// Adds value to the end of the list, in a new block when the last one is full.
+			void push_back( Int value )
+			{
+				if( m_tail != nullptr )
+				{
+					unsigned_type delta = zigzag( m_tail->last, value );
+					if( m_tail->bytes + encoded_size( delta ) <= block_bytes )
+					{
+						m_tail->bytes = static_cast< uint16_t >( encode( m_tail->data + m_tail->bytes, delta ) - m_tail->data );
+						m_tail->last = value;
+						m_tail->count++;
+						m_size++;
+						return;
+					}
+				}
+
+				Block * block = new_block();
+				block->first = block->last = value;
+				block->count = 1;
+				link_after( m_tail, block );
+				m_size++;
+			}
+
+			/// Adds value to the front of the list.
+			void push_front( Int value )
+			{ insert( begin(), value ); }
+
+			/// Removes the first element.
+			void pop_front( )
+			{
+				if( m_size != 0 )
+					erase( begin() );
+			}
+
+			/// Removes the last element.
+			void pop_back( )
+			{
+				if( m_size != 0 )
+					erase( std::prev( end() ) );
+			}
+
+			/// Calls f on every value in order, decoding a whole block at a time.
+			template< typename F >
+			void for_each( F f ) const
+			{
+				for( const Block * block = m_head ; block != nullptr ; block = block->next )
+				{
+					unsigned_type value = static_cast< unsigned_type >( block->first );
+					f( static_cast< Int >( value ) );
+
+					const unsigned char * read = block->data;
+					const unsigned char * stop = block->data + block->bytes;
+					while( read != stop )
+					{
+						// One byte deltas, |step| < 64, are the common case of sorted and clustered data.
+						unsigned_type z = *read++;
+						if( z & 0x80 )
+							read = decode_rest( read, z );
+						value += unzigzag( z );
+						f( static_cast< Int >( value ) );
+					}
+				}
+			}
+
+			//=== Operators overload
+			/// Copies the blocks of other.
+			compressed_list& operator=( const compressed_list& other )
+			{
+				if( this != &other )
+				{
+					clear();
+					append_blocks( other );
+				}
+
+				return *this;
+			}
+
+			/// Takes the blocks of other, which is left empty. The allocators must compare equal.
+			compressed_list& operator=( compressed_list&& other ) noexcept
+			{
+				if( this != &other )
+				{
+					clear();
+					std::swap( m_size, other.m_size );
+					std::swap( m_blocks, other.m_blocks );
+					std::swap( m_head, other.m_head );
+					std::swap( m_tail, other.m_tail );
+				}
+
+				return *this;
+			}
+
+			/// Checks if the lists hold the same values, whatever their blocks.
+			bool operator==( const compressed_list& rhs ) const
+			{
+				if( m_size != rhs.m_size )
+					return false;
+
+				for( my_const_iterator a = begin(), b = rhs.begin() ; a != end() ; ++a, ++b )
+				{
+					if( *a != *b )
+						return false;
+				}
+
+				return true;
+			}
+
+			/// Checks if the contents of the lists are different.
+			bool operator!=( const compressed_list& rhs ) const
+			{ return not( *this == rhs ); }
+
+			//=== Operations
+			/// Adds value just before pos, re-encoding its block. Returns an iterator to the inserted element.
+			my_const_iterator insert( my_const_iterator pos, Int value )
+			{
+				if( pos.m_block == nullptr )
+				{
+					push_back( value );
+					return std::prev( end() );
+				}
+
+				Block * block = const_cast< Block * >( pos.m_block );
+				std::array< Int, max_count + 1 > values;
+				size_t n = decode_block( block, values.data() );
+				for( size_t i = n ; i > pos.m_index ; i-- )
+					values[i] = values[i - 1];
+				values[pos.m_index] = value;
+				m_size++;
+
+				return rewrite( block, values.data(), n + 1, pos.m_index );
+			}
+
+			/// Removes the element at pos, re-encoding its block. Returns an iterator to the element that followed it.
+			my_const_iterator erase( my_const_iterator pos )
+			{
+				Block * block = const_cast< Block * >( pos.m_block );
+				m_size--;
+				if( block->count == 1 )
+				{
+					Block * after = block->next;
+					unlink( block );
+					return after == nullptr ? end() : my_const_iterator( this, after, 0, 0, after->first );
+				}
+
+				std::array< Int, max_count + 1 > values;
+				size_t n = decode_block( block, values.data() );
+				for( size_t i = pos.m_index ; i + 1 < n ; i++ )
+					values[i] = values[i + 1];
+
+				if( pos.m_index + size_t{1} == n )
+				{
+					// The last value of the block, what follows starts the next one.
+					rewrite( block, values.data(), n - 1, 0 );
+					return block->next == nullptr ? end() : my_const_iterator( this, block->next, 0, 0, block->next->first );
+				}
+				return rewrite( block, values.data(), n - 1, pos.m_index );
+			}
+
+			/// Removes the elements in [first; last). Returns last, or an iterator equal to it.
+			my_const_iterator erase( my_const_iterator first, my_const_iterator last )
+			{
+				size_type count = std::distance( first, last );
+				for( ; count > 0 ; count-- )
+					first = erase( first );
+
+				return first;
+			}
+
+			friend std::ostream& operator<<(std::ostream& os, const compressed_list& cl)
+			{
+				os << "[ ";
+				cl.for_each( [&os]( Int value ){ os << +value << " "; } );
+				os << "]";
+
+				return os;
+			}
+
+		private:
+			/// Allocates an empty block.
+			Block * new_block( )
+			{
+				Block * block = block_traits::allocate( m_alloc, 1 );
+				block_traits::construct( m_alloc, block );
+				return block;
+			}
+
+			/// Frees a block from new_block().
+			void delete_block( Block * block )
+			{
+				block_traits::destroy( m_alloc, block );
+				block_traits::deallocate( m_alloc, block, 1 );
+			}
+
+			/// Links block after before, or first when before is nullptr.
+			void link_after( Block * before, Block * block )
+			{
+				block->prev = before;
+				block->next = before == nullptr ? m_head : before->next;
+				if( block->next != nullptr )
+					block->next->prev = block;
+				else
+					m_tail = block;
+				if( before != nullptr )
+					before->next = block;
+				else
+					m_head = block;
+				m_blocks++;
+			}
+
+			/// Unlinks and frees block.
+			void unlink( Block * block )
+			{
+				if( block->prev != nullptr )
+					block->prev->next = block->next;
+				else
+					m_head = block->next;
+				if( block->next != nullptr )
+					block->next->prev = block->prev;
+				else
+					m_tail = block->prev;
+				delete_block( block );
+				m_blocks--;
+			}
+
+			/// Appends copies of the blocks of other.
+			void append_blocks( const compressed_list& other )
+			{
+				for( const Block * source = other.m_head ; source != nullptr ; source = source->next )
+				{
+					Block * block = new_block();
+					*block = *source;
+					link_after( m_tail, block );
+				}
+				m_size = other.m_size;
+			}
+
+			/// Re-encodes values[0; n) into block, and into a new block after it when they don't fit.
+			/// Returns an iterator to the value that was at index.
+			my_const_iterator rewrite( Block * block, const Int * values, size_t n, size_t index )
+			{
+				size_t total = 0;
+				for( size_t i = 1 ; i < n ; i++ )
+					total += encoded_size( zigzag( values[i - 1], values[i] ) );
+
+				size_t split = n;
+				if( total > block_bytes )
+				{
+					// Halves by bytes, each then holds about half of what overflowed one block.
+					size_t bytes = 0;
+					for( split = 1 ; bytes < total / 2 ; split++ )
+						bytes += encoded_size( zigzag( values[split - 1], values[split] ) );
+
+					Block * second = new_block();
+					encode_block( second, values + split, n - split );
+					link_after( block, second );
+				}
+				encode_block( block, values, split );
+
+				if( index >= split )
+					return seek( block->next, index - split );
+				return seek( block, index );
+			}
+
+			/// Returns an iterator to the value at index in block.
+			my_const_iterator seek( const Block * block, size_t index ) const
+			{
+				my_const_iterator it( this, block, 0, 0, block->first );
+				while( it.m_index != index )
+					++it;
+				return it;
+			}
+
+			/// Fills block with values[0; n), which must fit.
+			static void encode_block( Block * block, const Int * values, size_t n )
+			{
+				unsigned char * write = block->data;
+				for( size_t i = 1 ; i < n ; i++ )
+					write = encode( write, zigzag( values[i - 1], values[i] ) );
+
+				block->first = values[0];
+				block->last = values[n - 1];
+				block->count = static_cast< uint16_t >( n );
+				block->bytes = static_cast< uint16_t >( write - block->data );
+			}
+
+			/// Writes the values of block to out. Returns their number.
+			static size_t decode_block( const Block * block, Int * out )
+			{
+				unsigned_type value = static_cast< unsigned_type >( block->first );
+				size_t n = 0;
+				out[n++] = block->first;
+				for( const unsigned char * read = block->data ; read != block->data + block->bytes ; )
+				{
+					unsigned_type z = *read++;
+					if( z & 0x80 )
+						read = decode_rest( read, z );
+					value += unzigzag( z );
+					out[n++] = static_cast< Int >( value );
+				}
+				return n;
+			}
+
+			/// Returns the zigzag encoding of the step from previous to value.
+			static unsigned_type zigzag( Int previous, Int value )
+			{
+				unsigned_type delta = static_cast< unsigned_type >( static_cast< unsigned_type >( value ) - static_cast< unsigned_type >( previous ) );
+				unsigned_type sign = ( delta >> ( sizeof( Int ) * 8 - 1 ) ) ? ~unsigned_type{0} : unsigned_type{0};
+				return static_cast< unsigned_type >( ( delta << 1 ) ^ sign );
+			}
+
+			/// Returns the step, modulo 2^bits, zigzag encoded as z.
+			static unsigned_type unzigzag( unsigned_type z )
+			{ return static_cast< unsigned_type >( ( z >> 1 ) ^ ( unsigned_type{0} - ( z & 1 ) ) ); }
+
+			/// Returns the number of bytes encode() writes for z.
+			static size_t encoded_size( unsigned_type z )
+			{
+				size_t bytes = 1;
+				for( ; z >= 0x80 ; z >>= 7 )
+					bytes++;
+				return bytes;
+			}
+
+			/// Writes z 7 bits per byte, low bits first, the high bit set on all but the last byte. Returns the end.
+			static unsigned char * encode( unsigned char * write, unsigned_type z )
+			{
+				for( ; z >= 0x80 ; z >>= 7 )
+					*write++ = static_cast< unsigned char >( z | 0x80 );
+				*write++ = static_cast< unsigned char >( z );
+				return write;
+			}
+
+			/// Finishes decoding z, whose first byte was read, from read. Returns the end of the encoding.
+			static const unsigned char * decode_rest( const unsigned char * read, unsigned_type & z )
+			{
+				z &= 0x7f;
+				unsigned shift = 7;
+				unsigned_type byte;
+				do {
+					byte = *read++;
+					z |= static_cast< unsigned_type >( ( byte & 0x7f ) << shift );
+					shift += 7;
+				} while( byte & 0x80 );
+				return read;
+			}
+
+		public:
+		/*! \class my_const_iterator
+
+			Bidirectional iterator decoding the values on the way. Dereferencing returns the value.
+		*/
+		class my_const_iterator{
+			private:
+				typedef my_const_iterator iterator;
+
+				const compressed_list * m_owner; //!< List iterated, to step back from end().
+				const Block * m_block; //!< Block of the current value, nullptr at the end.
+				uint16_t m_pos; //!< Offset in the block data just after the current value's delta, 0 on first.
+				uint16_t m_index; //!< Index of the current value in its block.
+				Int m_value; //!< The current value.
+
+				friend class compressed_list;
+
+				my_const_iterator( const compressed_list * owner, const Block * block, uint16_t pos, uint16_t index, Int value )
+					: m_owner{owner}, m_block{block}, m_pos{pos}, m_index{index}, m_value{value}
+				{/*empty*/}
+
+			public:
+				//=== Alias
+				typedef std::bidirectional_iterator_tag iterator_category; //!< Blocks are linked both ways.
+				typedef Int value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef const Int * pointer; //!< Pointer to the decoded value.
+				typedef Int reference; //!< Values are decoded, read by value.
+
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				my_const_iterator()
+					: m_owner{nullptr}, m_block{nullptr}, m_pos{0}, m_index{0}, m_value{}
+				{/*empty*/}
+
+				//=== Operators
+				iterator & operator++(void)
+				{
+					if( m_index + 1 == m_block->count )
+					{
+						m_block = m_block->next;
+						m_pos = m_index = 0;
+						if( m_block != nullptr )
+							m_value = m_block->first;
+						return *this;
+					}
+
+					const unsigned char * read = m_block->data + m_pos;
+					unsigned_type z = *read++;
+					if( z & 0x80 )
+						read = decode_rest( read, z );
+					m_value = static_cast< Int >( static_cast< unsigned_type >( m_value ) + unzigzag( z ) );
+					m_pos = static_cast< uint16_t >( read - m_block->data );
+					m_index++;
+					return *this;
+				}
+
+				iterator operator++(int)
+				{
+					iterator temp( *this );
+					++*this;
+					return temp;
+				}
+
+				iterator & operator--(void)
+				{
+					if( m_block == nullptr or m_index == 0 )
+					{
+						m_block = m_block == nullptr ? m_owner->m_tail : m_block->prev;
+						m_value = m_block->last;
+						m_pos = m_block->bytes;
+						m_index = static_cast< uint16_t >( m_block->count - 1 );
+						return *this;
+					}
+
+					// The delta ends at m_pos, its first byte follows a byte without the high bit.
+					uint16_t start = static_cast< uint16_t >( m_pos - 1 );
+					while( start > 0 and ( m_block->data[start - 1] & 0x80 ) )
+						start--;
+					const unsigned char * read = m_block->data + start;
+					unsigned_type z = *read++;
+					if( z & 0x80 )
+						decode_rest( read, z );
+					m_value = static_cast< Int >( static_cast< unsigned_type >( m_value ) - unzigzag( z ) );
+					m_pos = start;
+					m_index--;
+					return *this;
+				}
+
+				iterator operator--(int)
+				{
+					iterator temp( *this );
+					--*this;
+					return temp;
+				}
+
+				reference operator*() const
+				{ return m_value; }
+
+				pointer operator->() const
+				{ return &m_value; }
+
+				bool operator==( const iterator& it2) const
+				{ return m_block == it2.m_block and m_index == it2.m_index; }
+
+				bool operator!=( const iterator& it2) const
+				{ return not( *this == it2 ); }
+		}; // class my_const_iterator
+
+	}; // class compressed_list
+
+	/// Erases all the elements of c for which pred returns true, rebuilding it. Returns the number of erased elements.
+	template< typename Int, typename Allocator, typename Pred >
+	size_t erase_if( compressed_list< Int, Allocator > & c, Pred pred )
+	{
+		compressed_list< Int, Allocator > kept( c.get_allocator() );
+		c.for_each( [&kept, &pred]( Int value ){
+			if( not pred( value ) )
+				kept.push_back( value );
+		} );
+
+		size_t erased = c.size() - kept.size();
+		c = std::move( kept );
+		return erased;
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,528 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+#include "list.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+
+	/*! \class external_sorter
+    	\brief sorts more elements than fit in memory, through sorted runs spilled to temporary files.
+
+    	Elements are gathered in an sc::list until it holds half the memory budget,
+    	then the list is sorted by relinking its nodes and written to a temporary file,
+    	in blocks of spill_block_bytes, while the other half fills up (write-behind).
+    	finish() frees both lists and k-way merges the runs, reading each one in blocks
+    	with the next block already being read (read-ahead). When there are too many
+    	runs for blocks of at least min_block_bytes, groups of runs are first merged
+    	into longer ones. The sort is stable.
+
+    	All the background reads and writes run one after the other on a single I/O
+    	thread, started by the first spill and kept until the sorter is destroyed.
+
+    	Runs are stored as raw bytes, so T must be trivially copyable. The temporary
+    	files are unlinked as soon as they are created and vanish with their descriptors.
+	*/
+	template< typename T, typename Compare = std::less< T > >
+	class external_sorter{
+		static_assert( std::is_trivially_copyable< T >::value, "external_sorter spills T as raw bytes" );
+
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			static constexpr size_type node_bytes=list< T >::node_bytes; //!< Memory taken by an element in a run.
+			static constexpr size_type min_block_bytes=1 << 12; //!< Smallest read buffer of a run while merging.
+			static constexpr size_type spill_block_bytes=1 << 20; //!< Write buffer of a spill, outside the budget.
+
+			//=== Attributes
+			/// A sorted run in a temporary file.
+			struct Run{
+				int fd;
+				size_type count;
+			};
+
+			/// Runs the background reads and writes in order on one long-lived thread.
+			class io_thread{
+				private:
+					std::mutex m_mutex; //!< Guards m_jobs and m_stop.
+					std::condition_variable m_ready; //!< Signals a job or the stop.
+					std::deque< std::packaged_task< void() > > m_jobs; //!< Jobs not started yet.
+					bool m_stop; //!< Set by the destructor, the thread ends once m_jobs is empty.
+					std::thread m_thread; //!< Runs the jobs.
+
+					void run( )
+					{
+						while( true )
+						{
+							std::unique_lock< std::mutex > lock( m_mutex );
+							m_ready.wait( lock, [this](){ return m_stop or not m_jobs.empty(); } );
+							if( m_jobs.empty() )
+								return;
+
+							std::packaged_task< void() > job = std::move( m_jobs.front() );
+							m_jobs.pop_front();
+							lock.unlock();
+							// Exceptions are kept in the job's future.
+							job();
+						}
+					}
+
+				public:
+					io_thread( )
+						: m_stop{false}, m_thread( [this](){ run(); } )
+					{/*empty*/}
+
+					io_thread( const io_thread& ) = delete;
+					io_thread& operator=( const io_thread& ) = delete;
+
+					/// Runs the pending jobs, then ends the thread.
+					~io_thread( )
+					{
+						{
+							std::lock_guard< std::mutex > lock( m_mutex );
+							m_stop = true;
+						}
+						m_ready.notify_one();
+						m_thread.join();
+					}
+
+					/// Queues job. The future rethrows its exception.
+					std::future< void > post( std::function< void() > job )
+					{
+						std::packaged_task< void() > task( std::move( job ) );
+						std::future< void > done = task.get_future();
+						{
+							std::lock_guard< std::mutex > lock( m_mutex );
+							m_jobs.push_back( std::move( task ) );
+						}
+						m_ready.notify_one();
+						return done;
+					}
+			};
+
+			/// Reads a run in blocks, the next block is read while the current one is consumed.
+			class RunReader{
+				private:
+					io_thread & m_io; //!< Runs the reads.
+					int m_fd; //!< File of the run.
+					off_t m_offset; //!< Where the next block starts.
+					size_type m_left; //!< Elements not requested yet.
+					size_type m_block; //!< Elements per block.
+					std::vector< T > m_current; //!< Block being consumed.
+					std::vector< T > m_next; //!< Block being read.
+					size_type m_pos; //!< Next element of m_current.
+					std::future< void > m_pending; //!< Read of m_next.
+
+					void schedule( )
+					{
+						if( m_left == 0 )
+							return;
+
+						size_type count = std::min( m_block, m_left );
+						m_next.resize( count );
+						off_t offset = m_offset;
+						m_pending = m_io.post( [this, count, offset]() {
+							read_all( m_fd, m_next.data(), count * sizeof( T ), offset );
+						} );
+						m_offset += count * sizeof( T );
+						m_left -= count;
+					}
+
+					void advance( )
+					{
+						m_pos = 0;
+						if( not m_pending.valid() )
+						{
+							m_current.clear();
+							return;
+						}
+
+						m_pending.get();
+						m_current.swap( m_next );
+						schedule();
+					}
+
+				public:
+					RunReader( io_thread & io, const Run & run, size_type block )
+						: m_io( io ), m_fd{run.fd}, m_offset{0}, m_left{run.count}, m_block{block}, m_pos{0}
+					{
+						schedule();
+						advance();
+					}
+
+					/// Waits for the read in flight, it fills m_next.
+					~RunReader( )
+					{
+						if( m_pending.valid() )
+							m_pending.wait();
+					}
+
+					RunReader( const RunReader& ) = delete;
+					RunReader& operator=( const RunReader& ) = delete;
+
+					bool empty( ) const
+					{ return m_pos == m_current.size(); }
+
+					const T & front( ) const
+					{ return m_current[m_pos]; }
+
+					void pop( )
+					{
+						if( ++m_pos == m_current.size() )
+							advance();
+					}
+			};
+
+			/// Writes a run in blocks, a full block is written while the next one fills up.
+			class RunWriter{
+				private:
+					io_thread & m_io; //!< Runs the writes.
+					int m_fd; //!< File of the run.
+					off_t m_offset; //!< Where the next block goes.
+					size_type m_block; //!< Elements per block.
+					std::vector< T > m_filling; //!< Block being filled.
+					std::vector< T > m_writing; //!< Block being written.
+					std::future< void > m_pending; //!< Write of m_writing.
+
+				public:
+					RunWriter( io_thread & io, int fd, size_type block )
+						: m_io( io ), m_fd{fd}, m_offset{0}, m_block{block}
+					{ m_filling.reserve( block ); }
+
+					/// Waits for the write in flight, it reads m_writing.
+					~RunWriter( )
+					{
+						if( m_pending.valid() )
+							m_pending.wait();
+					}
+
+					RunWriter( const RunWriter& ) = delete;
+					RunWriter& operator=( const RunWriter& ) = delete;
+
+					void push( const T & value )
+					{
+						m_filling.push_back( value );
+						if( m_filling.size() == m_block )
+							flush();
+					}
+
+					/// Starts writing the filled block, once the previous one is written.
+					void flush( )
+					{
+						wait();
+						if( m_filling.empty() )
+							return;
+
+						m_writing.swap( m_filling );
+						m_filling.clear();
+
+						off_t offset = m_offset;
+						m_pending = m_io.post( [this, offset]() {
+							write_all( m_fd, m_writing.data(), m_writing.size() * sizeof( T ), offset );
+						} );
+						m_offset += m_writing.size() * sizeof( T );
+					}
+
+					void wait( )
+					{
+						if( m_pending.valid() )
+							m_pending.get();
+					}
+			};
+
+			Compare m_comp; //!< Strict weak ordering of the elements.
+			size_type m_budget; //!< Bytes the sorter may keep in memory.
+			std::string m_tmpdir; //!< Directory of the temporary files.
+			size_type m_run_size; //!< Elements per run.
+			list< T > m_buffers[2]; //!< Run being filled and run being written.
+			int m_filling; //!< Index of the run being filled.
+			std::future< void > m_writing; //!< Write-behind of the other run.
+			std::vector< Run > m_runs; //!< Runs spilled so far, in input order.
+			std::unique_ptr< io_thread > m_io; //!< Background reads and writes, started by the first spill.
+
+		public:
+			//=== Constructors
+			/// Sorter keeping about memory_budget bytes in memory, spilling to files in tmpdir.
+			external_sorter( Compare comp, size_type memory_budget, std::string tmpdir = "/tmp" )
+				: m_comp( comp ), m_budget{memory_budget}, m_tmpdir( std::move( tmpdir ) ),
+				  m_run_size{ std::max< size_type >( memory_budget / 2 / node_bytes, 1 ) }, m_filling{0}
+			{/*empty*/}
+
+			external_sorter( const external_sorter& ) = delete;
+			external_sorter& operator=( const external_sorter& ) = delete;
+
+			/// Waits for the background writes and closes the remaining runs.
+			~external_sorter( )
+			{
+				if( m_writing.valid() )
+					m_writing.wait();
+				close_runs( m_runs );
+			}
+
+			//=== Methods
+			/// Returns the number of runs spilled so far.
+			size_type runs( ) const
+			{ return m_runs.size(); }
+
+			/// Adds value to the elements to sort.
+			void push( const T & value )
+			{
+				m_buffers[m_filling].push_back( value );
+				if( m_buffers[m_filling].size() == m_run_size )
+					spill();
+			}
+
+			/// Writes the elements in order to out and returns out past the last one. The sorter ends up empty.
+			template< typename OutputIt >
+			OutputIt finish( OutputIt out )
+			{
+				list< T > & last = m_buffers[m_filling];
+
+				// Everything fit in memory.
+				if( m_runs.empty() )
+				{
+					last.sort( m_comp );
+					for( auto it = last.begin() ; it != last.end() ; ++it )
+						*out++ = *it;
+					last.clear();
+					return out;
+				}
+
+				if( not last.empty() )
+					spill();
+				wait_write();
+
+				// The merge blocks get the whole budget, the lists' nodes have to go first.
+				for( list< T > & buffer : m_buffers )
+				{
+					buffer.clear();
+					buffer.shrink_to_fit();
+				}
+
+				// Fewer, longer runs until they can all be merged with large enough blocks.
+				while( m_runs.size() > fan_in() )
+				{
+					std::vector< Run > merged;
+					for( size_type first{0u} ; first < m_runs.size() ; first += fan_in() )
+					{
+						std::vector< Run > group( m_runs.begin() + first, m_runs.begin() + std::min( first + fan_in(), m_runs.size() ) );
+						if( group.size() == 1 )
+						{
+							merged.push_back( group.front() );
+							continue;
+						}
+
+						Run run{ open_temp(), 0 };
+						RunWriter writer( *m_io, run.fd, block_size( group.size() ) );
+						run.count = merge( group, [&writer]( const T & value ){ writer.push( value ); } );
+						writer.flush();
+						writer.wait();
+						close_runs( group );
+						merged.push_back( run );
+					}
+					m_runs.swap( merged );
+				}
+
+				std::vector< Run > runs;
+				runs.swap( m_runs );
+				merge( runs, [&out]( const T & value ){ *out++ = value; } );
+				close_runs( runs );
+
+				return out;
+			}
+
+		private:
+			/// Most runs merged at once, so that every one gets blocks of at least min_block_bytes.
+			size_type fan_in( ) const
+			{ return std::max< size_type >( m_budget / min_block_bytes / 2, 3 ) - 1; }
+
+			/// Elements per block when k runs are merged: two blocks per run, two for the output.
+			size_type block_size( size_type k ) const
+			{ return std::max< size_type >( m_budget / ( 2 * k + 2 ) / sizeof( T ), 1 ); }
+
+			/// Sorts the run being filled and writes it in the background, once the previous one is written.
+			void spill( )
+			{
+				list< T > & full = m_buffers[m_filling];
+				full.sort( m_comp );
+
+				wait_write();
+				// The written run's nodes are kept as spare capacity for the next one.
+				list< T > & done = m_buffers[1 - m_filling];
+				done.erase( done.begin(), done.end() );
+
+				int fd = open_temp();
+				m_runs.push_back( Run{ fd, full.size() } );
+				if( not m_io )
+					m_io.reset( new io_thread );
+
+				// One job writes the whole run, synchronously, in large blocks.
+				size_type block = std::max< size_type >( std::min( spill_block_bytes, full.size() * sizeof( T ) ) / sizeof( T ), 1 );
+				m_writing = m_io->post( [&full, fd, block]() {
+					std::vector< T > staging;
+					staging.reserve( block );
+					off_t offset = 0;
+					for( auto it = full.begin() ; it != full.end() ; ++it )
+					{
+						staging.push_back( *it );
+						if( staging.size() == block )
+						{
+							write_all( fd, staging.data(), block * sizeof( T ), offset );
+							offset += block * sizeof( T );
+							staging.clear();
+						}
+					}
+					write_all( fd, staging.data(), staging.size() * sizeof( T ), offset );
+				} );
+
+				m_filling = 1 - m_filling;
+			}
+
+			void wait_write( )
+			{
+				if( m_writing.valid() )
+					m_writing.get();
+			}
+
+			/// Merges runs in order into sink, ties go to the earlier run. Returns the number of merged elements.
+			template< typename Sink >
+			size_type merge( const std::vector< Run > & runs, Sink sink )
+			{
+				size_type block = block_size( runs.size() );
+				std::vector< std::unique_ptr< RunReader > > readers;
+				for( const Run & run : runs )
+					readers.emplace_back( new RunReader( *m_io, run, block ) );
+
+				auto later = [this, &readers]( size_type a, size_type b ){
+					if( m_comp( readers[b]->front(), readers[a]->front() ) )
+						return true;
+					if( m_comp( readers[a]->front(), readers[b]->front() ) )
+						return false;
+					return a > b;
+				};
+				std::priority_queue< size_type, std::vector< size_type >, decltype( later ) > heap( later );
+				for( size_type i{0u} ; i < readers.size() ; i++ )
+				{
+					if( not readers[i]->empty() )
+						heap.push( i );
+				}
+
+				size_type count = 0;
+				while( not heap.empty() )
+				{
+					size_type i = heap.top();
+					heap.pop();
+
+					sink( readers[i]->front() );
+					count++;
+
+					readers[i]->pop();
+					if( not readers[i]->empty() )
+						heap.push( i );
+				}
+
+				return count;
+			}
+
+			/// Creates an unlinked temporary file in m_tmpdir and returns its descriptor.
+			int open_temp( ) const
+			{
+				std::string path = m_tmpdir + "/sc_sort_XXXXXX";
+				int fd = mkstemp( &path[0] );
+				if( fd < 0 )
+					throw std::runtime_error( "error in external_sort(): can't create a file in " + m_tmpdir + ": " + std::strerror( errno ) );
+				unlink( path.c_str() );
+				return fd;
+			}
+
+			static void close_runs( const std::vector< Run > & runs )
+			{
+				for( const Run & run : runs )
+					close( run.fd );
+			}
+
+			static void write_all( int fd, const void * data, size_type bytes, off_t offset )
+			{
+				const char * first = static_cast< const char * >( data );
+				while( bytes > 0 )
+				{
+					ssize_t written = pwrite( fd, first, bytes, offset );
+					if( written < 0 and errno == EINTR )
+						continue;
+					if( written <= 0 )
+						throw std::runtime_error( std::string( "error in external_sort(): write failed: " ) + std::strerror( errno ) );
+
+					first += written;
+					offset += written;
+					bytes -= written;
+				}
+			}
+
+			static void read_all( int fd, void * data, size_type bytes, off_t offset )
+			{
+				char * first = static_cast< char * >( data );
+				while( bytes > 0 )
+				{
+					ssize_t got = pread( fd, first, bytes, offset );
+					if( got < 0 and errno == EINTR )
+						continue;
+					if( got <= 0 )
+						throw std::runtime_error( "error in external_sort(): read failed" );
+
+					first += got;
+					offset += got;
+					bytes -= got;
+				}
+			}
+	}; // class external_sorter
+
+
+	/// Sorts [first; last), a single pass input range that may not fit in memory, by comp into out.
+	/// Keeps about memory_budget bytes in memory and spills sorted runs to tmpdir. Returns out past the last element.
+	template< typename InputIt, typename OutputIt, typename Compare >
+	OutputIt external_sort( InputIt first, InputIt last, OutputIt out, Compare comp, size_t memory_budget, const std::string & tmpdir = "/tmp" )
+	{
+		typedef typename std::iterator_traits< InputIt >::value_type value_type;
+
+		external_sorter< value_type, Compare > sorter( comp, memory_budget, tmpdir );
+		for( ; first != last ; ++first )
+			sorter.push( *first );
+
+		return sorter.finish( out );
+	}
+
+	/// Sorts [first; last) by comp into a new sc::list, spilling to tmpdir beyond memory_budget bytes.
+	template< typename InputIt, typename Compare >
+	list< typename std::iterator_traits< InputIt >::value_type >
+	external_sort( InputIt first, InputIt last, Compare comp, size_t memory_budget, const std::string & tmpdir = "/tmp" )
+	{
+		list< typename std::iterator_traits< InputIt >::value_type > sorted;
+		external_sort( first, last, std::back_inserter( sorted ), comp, memory_budget, tmpdir );
+		return sorted;
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,675 @@
+#ifndef FORWARD_LIST_H
+#define FORWARD_LIST_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class forward_list
+    	\brief singly linked sc::list for queues and other forward-only uses.
+
+    	Nodes hold the element and a next pointer only: one pointer less per node and
+    	one pointer write less per link than sc::list. A tail pointer makes push_back()
+    	O(1) as well as push_front() and pop_front(). Positions are given as the node
+    	before them, hence insert_after(), erase_after() and splice_after().
+
+    	Like sc::list, the nodes come from Allocator rebound to them (so the
+    	thread_caching_allocator and its statistics work the same) and erased nodes
+    	are kept as spare capacity, see capacity(), reserve() and shrink_to_fit().
+    	Their elements are destroyed when they are erased, spare nodes hold none.
+	*/
+	template< typename T, typename Allocator = std::allocator< T > >
+	class forward_list{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+			static constexpr size_type initial_size=0; //!< Default value is 0.
+
+			//=== Attributes
+			struct Node{
+				union{ T data; }; //!< The element, alive only while the node is linked.
+				Node* next;
+
+				constexpr Node( )
+					: next{nullptr}
+				{/*empty*/}
+
+				constexpr ~Node( )
+				{/*empty*/}
+			};
+
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< Node > node_allocator; //!< Allocates the nodes.
+			typedef std::allocator_traits< node_allocator > node_traits; //!< Interface of node_allocator.
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< T > value_allocator; //!< Constructs the elements in the nodes.
+			typedef std::allocator_traits< value_allocator > value_traits; //!< Interface of value_allocator.
+
+			[[no_unique_address]] node_allocator m_alloc; //!< Source of every node, the sentinel included.
+			size_type m_size; //!< size of the list.
+			Node * head; //!< Sentinel before the first element.
+			Node * m_last; //!< Last element, head when the list is empty.
+			Node * m_free; //!< Spare nodes linked through next, reused before allocating.
+			size_type m_spare; //!< Number of spare nodes in m_free.
+
+		public:
+			class my_iterator;
+			class my_const_iterator;
+
+			//=== Standard container alias
+			typedef T value_type; //!< Type of the elements.
+			typedef T & reference; //!< Reference to an element.
+			typedef const T & const_reference; //!< Read-only reference to an element.
+			typedef my_iterator iterator; //!< Forward iterator.
+			typedef my_const_iterator const_iterator; //!< Read-only forward iterator.
+			typedef Allocator allocator_type; //!< Allocator the nodes are obtained from, rebound to them.
+
+			//=== Constructors
+			/// Default constructor.
+			constexpr forward_list( )
+				: m_size{initial_size}, head{new_node()}, m_last{head}, m_free{nullptr}, m_spare{0}
+			{/*empty*/}
+
+			/// Empty list allocating its nodes from alloc.
+			constexpr explicit forward_list( const Allocator & alloc )
+				: m_alloc( alloc ), m_size{initial_size}, head{new_node()}, m_last{head}, m_free{nullptr}, m_spare{0}
+			{/*empty*/}
+
+			/// Constructor with elements in [first, last) range. Single pass, so any input iterator works.
+			template< typename InputIt, typename = typename std::iterator_traits< InputIt >::iterator_category >
+			constexpr forward_list( InputIt first, InputIt last )
+				: forward_list()
+			{
+				for( ; first != last ; ++first )
+					push_back( *first );
+			}
+
+			/// Copy constructor.
+			constexpr forward_list( const forward_list& other )
+				: m_alloc( node_traits::select_on_container_copy_construction( other.m_alloc ) ), m_size{initial_size}, head{new_node()}, m_last{head}, m_free{nullptr}, m_spare{0}
+			{
+				for( Node * fast = other.head->next ; fast != nullptr ; fast = fast->next )
+					push_back( fast->data );
+			}
+
+			/// Move constructor, takes the nodes of other and leaves it empty.
+			constexpr forward_list( forward_list&& other )
+				: m_alloc( other.m_alloc ), m_size{initial_size}, head{new_node()}, m_last{head}, m_free{nullptr}, m_spare{0}
+			{
+				take_elements( other );
+			}
+
+			/// std::initializer_list copy constructor.
+			constexpr forward_list( std::initializer_list<T> ilist )
+				: forward_list( ilist.begin(), ilist.end() )
+			{/*empty*/}
+
+			/// Destructor.
+			constexpr ~forward_list( )
+			{
+				clear();
+				shrink_to_fit();
+				delete_node( head );
+			}
+
+			//=== Iterators
+			/// Returns an iterator to the sentinel before the first element, for insert_after() and splice_after().
+			constexpr my_iterator before_begin()
+			{ return my_iterator( head ); }
+
+			/// Returns an iterator pointing to the first item in the list.
+			constexpr my_iterator begin()
+			{ return my_iterator( head->next ); }
+
+			/// Returns a iterator pointing to the position just after the last item in the list.
+			constexpr my_iterator end()
+			{ return my_iterator( nullptr ); }
+
+			/// Returns an iterator to the last element, or before_begin() when the list is empty.
+			constexpr my_iterator before_end()
+			{ return my_iterator( m_last ); }
+
+			constexpr my_const_iterator before_begin() const
+			{ return my_const_iterator( head ); }
+
+			constexpr my_const_iterator begin() const
+			{ return my_const_iterator( head->next ); }
+
+			constexpr my_const_iterator end() const
+			{ return my_const_iterator( nullptr ); }
+
+			constexpr my_const_iterator cbegin() const
+			{ return my_const_iterator( head->next ); }
+
+			constexpr my_const_iterator cend() const
+			{ return my_const_iterator( nullptr ); }
+
+			//=== Methods
+			/// Returns the size of the list.
+			constexpr size_type size( ) const
+			{ return m_size; }
+
+			/// Checks if the list is empty.
+			constexpr bool empty( ) const
+			{ return m_size == 0; }
+
+			/// Returns a copy of the allocator.
+			allocator_type get_allocator( ) const
+			{ return allocator_type( m_alloc ); }
+
+			/// Returns the number of elements the list can hold before allocating new nodes.
+			constexpr size_type capacity( ) const
+			{ return m_size + m_spare; }
+
+			/// Preallocates spare nodes until the list can hold new_cap elements without allocating.
+			constexpr void reserve( size_type new_cap )
+			{
+				while( capacity() < new_cap )
+					keep_spare( new_node() );
+			}
+
+			/// Frees the spare nodes, capacity() becomes size().
+			constexpr void shrink_to_fit( )
+			{
+				while( m_free != nullptr )
+				{
+					Node * target = m_free;
+					m_free = m_free->next;
+					delete_node( target );
+				}
+				m_spare = 0;
+			}
+
+			/// Removes all the elements, their nodes are kept as spare capacity.
+			constexpr void clear( )
+			{
+				if( m_size == 0 )
+					return;
+
+				if( not std::is_trivially_destructible< T >::value )
+				{
+					value_allocator alloc( m_alloc );
+					for( Node * fast = head->next ; fast != nullptr ; fast = fast->next )
+						value_traits::destroy( alloc, std::addressof( fast->data ) );
+				}
+
+				m_last->next = m_free;
+				m_free = head->next;
+				m_spare += m_size;
+
+				head->next = nullptr;
+				m_last = head;
+				m_size = initial_size;
+			}
+
+			/// Adds value to the front of the list.
+			constexpr void push_front( const T & value )
+			{
+				insert_after( before_begin(), value );
+			}
+
+			constexpr void push_front( T && value )
+			{
+				insert_after( before_begin(), std::move( value ) );
+			}
+
+			/// Adds value to the end of the list.
+			constexpr void push_back( const T & value )
+			{
+				link_back( create_node( value ) );
+			}
+
+			constexpr void push_back( T && value )
+			{
+				link_back( create_node( std::move( value ) ) );
+			}
+
+			/// Removes the object at the front of the list.
+			constexpr void pop_front( )
+			{
+				if( m_size == 0 )
+					return;
+
+				erase_after( before_begin() );
+			}
+
+			/// Returns the object at the beginning of the list.
+			constexpr const T & front( ) const
+			{ return head->next->data; }
+
+			/// Returns the object at the end of the list.
+			constexpr const T & back( ) const
+			{ return m_last->data; }
+
+			//=== Operators overload
+			/// Replaces the contents with copies of other's elements, reusing the nodes.
+			constexpr forward_list& operator=( const forward_list& other )
+			{
+				if( this != &other )
+				{
+					clear();
+					for( Node * fast = other.head->next ; fast != nullptr ; fast = fast->next )
+						push_back( fast->data );
+				}
+
+				return *this;
+			}
+
+			/// Takes the nodes of other and leaves it empty. Allocators that neither compare equal nor
+			/// propagate can't free each other's nodes: the elements are moved one by one instead.
+			constexpr forward_list& operator=( forward_list&& other )
+			{
+				if( this == &other )
+					return *this;
+
+				clear();
+				if( node_traits::propagate_on_container_move_assignment::value and not( m_alloc == other.m_alloc ) )
+				{
+					// The sentinel and the spare nodes go back to the allocator they came from.
+					shrink_to_fit();
+					delete_node( head );
+					m_alloc = other.m_alloc;
+					head = m_last = new_node();
+				}
+
+				if( m_alloc == other.m_alloc )
+					take_elements( other );
+				else
+				{
+					for( Node * fast = other.head->next ; fast != nullptr ; fast = fast->next )
+						push_back( std::move( fast->data ) );
+					other.clear();
+				}
+
+				return *this;
+			}
+
+			/// Replaces the contents with the elements of ilist.
+			constexpr forward_list& operator=( std::initializer_list<T> ilist )
+			{
+				clear();
+				for( const T & e : ilist )
+					push_back( e );
+
+				return *this;
+			}
+
+			/// Checks if the contents of the lists are equal.
+			constexpr bool operator==( const forward_list& rhs ) const
+			{
+				if( m_size != rhs.m_size )
+					return false;
+
+				for( Node * a = head->next, * b = rhs.head->next ; a != nullptr ; a = a->next, b = b->next )
+				{
+					if( not( a->data == b->data ) )
+						return false;
+				}
+
+				return true;
+			}
+
+			/// Checks if the contents of the lists are different.
+			constexpr bool operator!=( const forward_list& rhs ) const
+			{ return not( *this == rhs ); }
+
+			//=== Operations
+			/// Adds value just after pos. Returns an iterator to the inserted element.
+			constexpr my_iterator insert_after( my_iterator pos, const T & value )
+			{
+				return link_after( pos.getIt(), create_node( value ) );
+			}
+
+			constexpr my_iterator insert_after( my_iterator pos, T && value )
+			{
+				return link_after( pos.getIt(), create_node( std::move( value ) ) );
+			}
+
+			/// Adds the elements of [first; last) just after pos. Returns an iterator to the last inserted element, or pos.
+			template< typename InItr >
+			constexpr my_iterator insert_after( my_iterator pos, InItr first, InItr last )
+			{
+				for( ; first != last ; ++first )
+					pos = insert_after( pos, *first );
+
+				return pos;
+			}
+
+			/// Adds the elements of ilist just after pos. Returns an iterator to the last inserted element, or pos.
+			constexpr my_iterator insert_after( my_iterator pos, std::initializer_list< T > ilist )
+			{
+				return insert_after( pos, ilist.begin(), ilist.end() );
+			}
+
+			/// Removes the element after pos. Returns an iterator to the element that followed it.
+			constexpr my_iterator erase_after( my_iterator pos )
+			{
+				Node * before = pos.getIt();
+				Node * target = before->next;
+				before->next = target->next;
+				if( target == m_last )
+					m_last = before;
+
+				recycle_node( target );
+				m_size--;
+
+				return my_iterator( before->next );
+			}
+
+			/// Removes the elements in (first; last). Returns last.
+			constexpr my_iterator erase_after( my_iterator first, my_iterator last )
+			{
+				while( my_iterator( first.getIt()->next ) != last )
+					erase_after( first );
+
+				return last;
+			}
+
+			/// Removes every element for which p returns true, each one as soon as p returns. Returns the number of
+			/// removed elements.
+			template< typename UnaryPredicate >
+			constexpr size_type remove_if( UnaryPredicate p )
+			{
+				size_type count = 0;
+				for( Node * before = head ; before->next != nullptr ; )
+				{
+					if( p( before->next->data ) )
+					{
+						erase_after( my_iterator( before ) );
+						count++;
+					}
+					else
+						before = before->next;
+				}
+
+				return count;
+			}
+
+			/// Removes every element equal to value. Returns the number of removed elements.
+			constexpr size_type remove( const T & value )
+			{
+				return remove_if( [&value]( const T & e ){ return e == value; } );
+			}
+
+			/// Moves every element of other just after pos, in O(1). The allocators must compare equal.
+			constexpr void splice_after( my_iterator pos, forward_list & other )
+			{
+				if( &other == this or other.m_size == 0 )
+					return;
+
+				Node * before = pos.getIt();
+				other.m_last->next = before->next;
+				before->next = other.head->next;
+				if( before == m_last )
+					m_last = other.m_last;
+				m_size += other.m_size;
+
+				other.head->next = nullptr;
+				other.m_last = other.head;
+				other.m_size = initial_size;
+			}
+
+			/// Moves the element after it, in other, just after pos, relinking its node. The allocators must compare equal.
+			constexpr void splice_after( my_iterator pos, forward_list & other, my_iterator it )
+			{
+				Node * before = pos.getIt();
+				Node * source = it.getIt();
+				Node * node = source->next;
+				if( before == source or before == node )
+					return;
+
+				source->next = node->next;
+				if( node == other.m_last )
+					other.m_last = source;
+				other.m_size--;
+
+				node->next = before->next;
+				before->next = node;
+				if( before == m_last )
+					m_last = node;
+				m_size++;
+			}
+
+			friend std::ostream& operator<<(std::ostream& os, const forward_list& fl)
+			{
+				os << "[ ";
+				for( Node * fast = fl.head->next ; fast != nullptr ; fast = fast->next )
+					os << fast->data << " ";
+				os << "]";
+
+				return os;
+			}
+
+		private:
+			/// Allocates a node without an element.
+			constexpr Node * new_node( )
+			{
+				Node * node = node_traits::allocate( m_alloc, 1 );
+				node_traits::construct( m_alloc, node );
+				return node;
+			}
+
+			/// Frees a node holding no element: a spare node or the sentinel.
+			constexpr void delete_node( Node * node )
+			{
+				node_traits::destroy( m_alloc, node );
+				node_traits::deallocate( m_alloc, node, 1 );
+			}
+
+			/// Returns a node holding an element constructed in place from args, a spare node when there is one.
+			template< typename... Args >
+			constexpr Node * create_node( Args &&... args )
+			{
+				Node * node = m_free;
+				if( node == nullptr )
+					node = new_node();
+				else
+				{
+					m_free = m_free->next;
+					m_spare--;
+				}
+
+				try
+				{
+					value_allocator alloc( m_alloc );
+					value_traits::construct( alloc, std::addressof( node->data ), std::forward< Args >( args )... );
+				}
+				catch( ... )
+				{
+					keep_spare( node );
+					throw;
+				}
+				return node;
+			}
+
+			/// Destroys the element of an unlinked node and keeps the node as spare capacity.
+			constexpr void recycle_node( Node * target )
+			{
+				value_allocator alloc( m_alloc );
+				value_traits::destroy( alloc, std::addressof( target->data ) );
+				keep_spare( target );
+			}
+
+			/// Keeps a node holding no element as spare capacity.
+			constexpr void keep_spare( Node * target )
+			{
+				target->next = m_free;
+				m_free = target;
+				m_spare++;
+			}
+
+			/// Links node after the last element.
+			constexpr void link_back( Node * node )
+			{
+				node->next = nullptr;
+				m_last->next = node;
+				m_last = node;
+
+				m_size++;
+			}
+
+			/// Links node just after before. Returns an iterator to it.
+			constexpr my_iterator link_after( Node * before, Node * node )
+			{
+				node->next = before->next;
+				before->next = node;
+				if( before == m_last )
+					m_last = node;
+
+				m_size++;
+
+				return my_iterator( node );
+			}
+
+			/// Relinks the elements of other after the sentinel of this empty list.
+			constexpr void take_elements( forward_list & other )
+			{
+				if( other.m_size == 0 )
+					return;
+
+				head->next = other.head->next;
+				m_last = other.m_last;
+				m_size = other.m_size;
+
+				other.head->next = nullptr;
+				other.m_last = other.head;
+				other.m_size = initial_size;
+			}
+
+		public:
+		/*! \class my_iterator
+
+			Forward iterator over the elements.
+		*/
+		class my_iterator{
+			private:
+				Node * it; //!< Iterator pointer
+				typedef my_iterator iterator;
+
+			public:
+				//=== Alias
+				typedef std::forward_iterator_tag iterator_category; //!< Nodes are linked one way.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef T * pointer; //!< Pointer to an element.
+				typedef T & reference; //!< Reference to an element.
+
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				constexpr my_iterator()
+					: it{nullptr}
+				{/*empty*/}
+
+				constexpr explicit my_iterator(Node * it)
+					: it{it}
+				{/*empty*/}
+
+				//=== Operators
+				constexpr iterator & operator++(void)
+				{
+					it = it->next;
+					return *this;
+				}
+
+				constexpr iterator operator++(int)
+				{
+					iterator temp( it );
+					it = it->next;
+					return temp;
+				}
+
+				constexpr reference operator*() const
+				{ return it->data; }
+
+				constexpr pointer operator->() const
+				{ return &it->data; }
+
+				constexpr bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				constexpr bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+
+				constexpr Node * getIt() const
+				{ return it; }
+		}; // class my_iterator
+
+
+		/*! \class my_const_iterator
+
+			Forward iterator giving read-only access to the elements. A my_iterator converts to it.
+		*/
+		class my_const_iterator{
+			private:
+				const Node * it; //!< Iterator pointer
+				typedef my_const_iterator iterator;
+
+			public:
+				//=== Alias
+				typedef std::forward_iterator_tag iterator_category; //!< Nodes are linked one way.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef const T * pointer; //!< Pointer to an element.
+				typedef const T & reference; //!< Reference to an element.
+
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				constexpr my_const_iterator()
+					: it{nullptr}
+				{/*empty*/}
+
+				constexpr explicit my_const_iterator(const Node * it)
+					: it{it}
+				{/*empty*/}
+
+				constexpr my_const_iterator( my_iterator other )
+					: it{ other.getIt() }
+				{/*empty*/}
+
+				//=== Operators
+				constexpr iterator & operator++(void)
+				{
+					it = it->next;
+					return *this;
+				}
+
+				constexpr iterator operator++(int)
+				{
+					iterator temp( it );
+					it = it->next;
+					return temp;
+				}
+
+				constexpr reference operator*() const
+				{ return it->data; }
+
+				constexpr pointer operator->() const
+				{ return &it->data; }
+
+				constexpr bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				constexpr bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+		}; // class my_const_iterator
+
+	}; // class forward_list
+
+	/// Erases all the elements of c for which pred returns true. Returns the number of erased elements.
+	template< typename T, typename Allocator, typename Pred >
+	size_t erase_if( forward_list< T, Allocator > & c, Pred pred )
+	{
+		return c.remove_if( pred );
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,532 @@
+#ifndef HASHED_LIST_H
+#define HASHED_LIST_H
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/// Key extractor of hashed_list that uses the whole value as its key.
+	struct identity_key{
+		template< typename T >
+		constexpr const T & operator()( const T & value ) const
+		{ return value; }
+	};
+
+	/// Key extractor of hashed_list for pair-like values, the key is the first member.
+	struct first_key{
+		template< typename Pair >
+		constexpr const auto & operator()( const Pair & value ) const
+		{ return value.first; }
+	};
+
+	/// Type of the keys KeyOf extracts from the values of a hashed_list.
+	template< typename T, typename KeyOf >
+	using hashed_key_t = std::remove_cvref_t< std::invoke_result_t< KeyOf, const T & > >;
+
+	/*! \class hashed_list
+    	\brief linked list of unique values with an O(1) index from value to node.
+
+    	Iteration follows insertion order, like sc::list. Next to the links, an
+    	open-addressing table (linear probing, backward shift deletion) maps every
+    	key to its node, so find, contains, erase( key ) and move_to_back( key )
+    	don't need to scan the list.
+
+    	KeyOf extracts the key from a value, Hash and KeyEqual work on that key. With
+    	first_key and std::pair< const K, V > values the container replaces the usual
+    	std::unordered_map< K, std::list< V >::iterator > next to a list, and stores
+    	each key once.
+
+    	Memory per element: a node holding the value and two links, plus the table.
+    	A slot is a node pointer and the hash (16 bytes), and the table is kept
+    	between a quarter and half full, so it adds 32 to 64 bytes per element.
+    	Erased elements leave their nodes as spares, reused by the next insertions
+    	until shrink_to_fit(), so a list that keeps its size never allocates.
+	*/
+	template< typename T, typename KeyOf = identity_key, typename Hash = std::hash< hashed_key_t< T, KeyOf > >,
+		typename KeyEqual = std::equal_to< hashed_key_t< T, KeyOf > > >
+	class hashed_list{
+		public:
+			//=== Alias
+			typedef hashed_key_t< T, KeyOf > key_type; //!< Type of the index keys.
+			/// With the identity key the elements are the keys, so they are read-only.
+			typedef std::conditional_t< std::is_same_v< KeyOf, identity_key >, const T &, T & > reference;
+
+		private:
+			typedef size_t size_type; //!< Type of size.
+			static constexpr size_type initial_size=0; //!< Default value is 0.
+			static constexpr size_type initial_buckets=8; //!< Smallest table size, always a power of two.
+
+			//=== Attributes
+			struct Node{
+				union{ T data; }; //!< The element, alive only while the node is linked.
+				Node* next;
+				Node* prev;
+
+				constexpr Node( )
+					: next{nullptr}, prev{nullptr}
+				{/*empty*/}
+
+				constexpr ~Node( )
+				{/*empty*/}
+			};
+
+			/// Table slot, node is nullptr while the slot is empty. The hash is only kept here.
+			struct Slot{
+				Node * node;
+				size_t hash;
+			};
+
+			size_type m_size; //!< size of the list.
+			Node * head; //!< Head Node pointer.
+			Node * tail; //!< Tail Node pointer.
+			Node * m_free; //!< Spare nodes holding no element, linked through next.
+			std::vector< Slot > m_slots; //!< Open-addressing index, at most half full.
+			int m_shift; //!< 64 minus the log2 of the table size, see home().
+			Hash m_hash; //!< Hash function.
+			KeyEqual m_equal; //!< Equality of keys.
+			KeyOf m_key; //!< Key extractor.
+
+			template< bool Const >
+			class my_basic_iterator;
+
+		public:
+			typedef my_basic_iterator< false > my_iterator; //!< Bidirectional iterator.
+			typedef my_basic_iterator< true > my_const_iterator; //!< Read-only bidirectional iterator.
+
+			//=== Constructors
+			/// Default constructor.
+			hashed_list( )
+				: m_size{initial_size}, head{new Node}, tail{new Node}, m_free{nullptr}, m_slots( initial_buckets, Slot{ nullptr, 0 } ),
+				  m_shift{ 64 - std::countr_zero( initial_buckets ) }
+			{
+				head->next = tail;
+				head->prev = nullptr;
+				tail->prev = head;
+				tail->next = nullptr;
+			}
+
+			/// std::initializer_list constructor, repeated values are kept once.
+			hashed_list( std::initializer_list<T> ilist )
+				: hashed_list()
+			{
+				for( const T& e : ilist )
+					push_back( e );
+			}
+
+			/// Copy constructor.
+			hashed_list( const hashed_list& other )
+				: hashed_list()
+			{
+				for( Node * fast = other.head->next ; fast != other.tail ; fast = fast->next )
+					push_back( fast->data );
+			}
+
+			hashed_list& operator=( const hashed_list& other )
+			{
+				if( this != &other )
+				{
+					clear();
+					for( Node * fast = other.head->next ; fast != other.tail ; fast = fast->next )
+						push_back( fast->data );
+				}
+				return *this;
+			}
+
+			/// Destructor.
+			~hashed_list( )
+			{
+				clear();
+				shrink_to_fit();
+				delete head;
+				delete tail;
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item in the list.
+			my_iterator begin()
+			{ return my_iterator( head->next ); }
+
+			/// Returns a iterator pointing to the position just after the last item in the list.
+			my_iterator end()
+			{ return my_iterator( tail ); }
+
+			my_const_iterator begin() const
+			{ return my_const_iterator( head->next ); }
+
+			my_const_iterator end() const
+			{ return my_const_iterator( tail ); }
+
+			//=== Methods
+			/// Returns the size of the list.
+			size_type size( ) const
+			{return this->m_size;}
+
+			/// Checks if the list is empty.
+			bool empty( ) const
+			{return m_size == 0;}
+
+			/// Delete all the elements, their nodes are kept for the next insertions.
+			void clear( )
+			{
+				Node * fast = head->next;
+				while( fast != tail )
+				{
+					Node * target = fast;
+					fast = fast->next;
+					recycle_node( target );
+				}
+
+				head->next = tail;
+				tail->prev = head;
+				m_size = initial_size;
+
+				for( Slot & slot : m_slots )
+					slot = Slot{ nullptr, 0 };
+			}
+
+			/// Frees the spare nodes left by erased elements.
+			void shrink_to_fit( )
+			{
+				while( m_free != nullptr )
+				{
+					Node * target = m_free;
+					m_free = m_free->next;
+					delete target;
+				}
+			}
+
+			/// Returns the object at the beginning of the list.
+			const T & front( ) const
+			{ return head->next->data; }
+
+			/// Returns the object at the end of the list.
+			const T & back( ) const
+			{ return tail->prev->data; }
+
+			/// Appends value if it is not in the list yet. Returns an iterator to the element equal to value
+			/// and whether it was inserted.
+			std::pair< my_iterator, bool > push_back( const T & value )
+			{ return insert( end(), value ); }
+
+			std::pair< my_iterator, bool > push_back( T && value )
+			{ return insert( end(), std::move( value ) ); }
+
+			/// Prepends value if it is not in the list yet. Returns an iterator to the element equal to value
+			/// and whether it was inserted.
+			std::pair< my_iterator, bool > push_front( const T & value )
+			{ return insert( begin(), value ); }
+
+			std::pair< my_iterator, bool > push_front( T && value )
+			{ return insert( begin(), std::move( value ) ); }
+
+			/// Adds value before pos if it is not in the list yet. Returns an iterator to the element equal to value
+			/// and whether it was inserted.
+			std::pair< my_iterator, bool > insert( my_iterator pos, const T & value )
+			{ return emplace( pos, value ); }
+
+			std::pair< my_iterator, bool > insert( my_iterator pos, T && value )
+			{ return emplace( pos, std::move( value ) ); }
+
+		private:
+			/// Links a node holding value before pos unless its key is already in the list.
+			template< typename V >
+			std::pair< my_iterator, bool > emplace( my_iterator pos, V && value )
+			{
+				size_t hash = m_hash( m_key( value ) );
+				size_type slot = find_slot( m_key( value ), hash );
+				if( m_slots[slot].node != nullptr )
+					return std::make_pair( my_iterator( m_slots[slot].node ), false );
+
+				Node * temp = pos.getIt();
+				Node * newNode = create_node( std::forward< V >( value ) );
+				newNode->next = temp;
+				newNode->prev = temp->prev;
+
+				temp->prev = newNode;
+				newNode->prev->next = newNode;
+
+				m_slots[slot] = Slot{ newNode, hash };
+				m_size++;
+
+				// Keeps the load factor at most 1/2.
+				if( 2 * m_size > m_slots.size() )
+					rehash( 2 * m_slots.size() );
+
+				return std::make_pair( my_iterator( newNode ), true );
+			}
+
+		public:
+			/// Removes the object at the front of the list.
+			void pop_front( )
+			{
+				if(m_size == 0)
+					return;
+
+				erase( begin() );
+			}
+
+			/// Removes the object at the end of the list.
+			void pop_back( )
+			{
+				if(m_size == 0)
+					return;
+
+				erase( my_iterator( tail->prev ) );
+			}
+
+			/// Returns an iterator to the element with the given key, or end() when there is none.
+			my_iterator find( const key_type & key )
+			{ return my_iterator( find_node( key ) ); }
+
+			my_const_iterator find( const key_type & key ) const
+			{ return my_const_iterator( find_node( key ) ); }
+
+			/// Checks if an element with the given key is in the list.
+			bool contains( const key_type & key ) const
+			{ return m_slots[ find_slot( key, m_hash( key ) ) ].node != nullptr; }
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			my_iterator erase( my_iterator pos )
+			{
+				Node * target = pos.getIt();
+				pos++;
+
+				const key_type & key = m_key( target->data );
+				erase_slot( find_slot( key, m_hash( key ) ) );
+
+				target->next->prev = target->prev;
+				target->prev->next = target->next;
+				recycle_node( target );
+
+				m_size--;
+
+				return pos;
+			}
+
+			/// Removes the element with the given key. Returns the number of removed elements (0 or 1).
+			size_type erase( const key_type & key )
+			{
+				my_iterator pos = find( key );
+				if( pos == end() )
+					return 0;
+
+				erase( pos );
+				return 1;
+			}
+
+			/// Moves the element with the given key to the end of the list, without reallocating it.
+			/// Returns false when there is no such element.
+			bool move_to_back( const key_type & key )
+			{
+				my_iterator pos = find( key );
+				if( pos == end() )
+					return false;
+
+				move_to_back( pos );
+				return true;
+			}
+
+			/// Moves the element at pos to the end of the list, without reallocating it.
+			void move_to_back( my_iterator pos )
+			{
+				Node * target = pos.getIt();
+				if( target->next == tail )
+					return;
+
+				target->next->prev = target->prev;
+				target->prev->next = target->next;
+
+				target->next = tail;
+				target->prev = tail->prev;
+				tail->prev->next = target;
+				tail->prev = target;
+			}
+
+		private:
+			/// Returns an unlinked node holding an element built from value, reusing a spare node if there is one.
+			template< typename V >
+			Node * create_node( V && value )
+			{
+				Node * node = m_free;
+				if( node != nullptr )
+					m_free = node->next;
+				else
+					node = new Node;
+
+				try
+				{
+					std::construct_at( std::addressof( node->data ), std::forward< V >( value ) );
+				}
+				catch( ... )
+				{
+					node->next = m_free;
+					m_free = node;
+					throw;
+				}
+				return node;
+			}
+
+			/// Destroys the element of an unlinked node and keeps the node as spare.
+			void recycle_node( Node * target )
+			{
+				std::destroy_at( std::addressof( target->data ) );
+				target->next = m_free;
+				m_free = target;
+			}
+
+			/// Returns the node with the given key, or the tail when there is none.
+			Node * find_node( const key_type & key ) const
+			{
+				Node * node = m_slots[ find_slot( key, m_hash( key ) ) ].node;
+				return node != nullptr ? node : tail;
+			}
+
+			size_type mask( ) const
+			{ return m_slots.size() - 1; }
+
+			/// Returns the first slot probed for hash. The hash is mixed with a fibonacci multiply-shift first:
+			/// std::hash is the identity for integers, and masking its low bits would cluster strided keys.
+			size_type home( size_t hash ) const
+			{ return static_cast< size_type >( ( static_cast< std::uint64_t >( hash ) * 0x9E3779B97F4A7C15ull ) >> m_shift ); }
+
+			/// Returns the slot holding key, or the empty slot where it would go.
+			size_type find_slot( const key_type & key, size_t hash ) const
+			{
+				size_type slot = home( hash );
+				while( m_slots[slot].node != nullptr )
+				{
+					if( m_slots[slot].hash == hash and m_equal( m_key( m_slots[slot].node->data ), key ) )
+						break;
+					slot = ( slot + 1 ) & mask();
+				}
+				return slot;
+			}
+
+			/// Empties slot and shifts back the entries of its probe run, so lookups need no tombstones.
+			void erase_slot( size_type slot )
+			{
+				size_type fast = slot;
+				while( true )
+				{
+					fast = ( fast + 1 ) & mask();
+					if( m_slots[fast].node == nullptr )
+						break;
+
+					// An entry may fill the hole only if its home slot is not between the hole and itself.
+					size_type start = home( m_slots[fast].hash );
+					if( ( ( fast - start ) & mask() ) >= ( ( fast - slot ) & mask() ) )
+					{
+						m_slots[slot] = m_slots[fast];
+						slot = fast;
+					}
+				}
+				m_slots[slot] = Slot{ nullptr, 0 };
+			}
+
+			void rehash( size_type buckets )
+			{
+				std::vector< Slot > slots( buckets, Slot{ nullptr, 0 } );
+				m_slots.swap( slots );
+				m_shift = 64 - std::countr_zero( buckets );
+
+				for( const Slot & entry : slots )
+				{
+					if( entry.node == nullptr )
+						continue;
+
+					size_type slot = home( entry.hash );
+					while( m_slots[slot].node != nullptr )
+						slot = ( slot + 1 ) & mask();
+					m_slots[slot] = entry;
+				}
+			}
+
+		/*! \class my_basic_iterator
+
+			Bidirectional iterator in insertion order, read-only when Const is set. With the identity key
+			the elements are always read-only, otherwise the key part of an element must not be modified
+			through it.
+		*/
+		template< bool Const >
+		class my_basic_iterator{
+			private:
+				Node * it; //!< Iterator pointer
+				typedef my_basic_iterator iterator;
+
+				friend class hashed_list;
+
+			public:
+				//=== Alias
+				typedef std::conditional_t< Const, const T &, hashed_list::reference > reference; //!< Reference to an element.
+				typedef std::remove_reference_t< reference > * pointer; //!< Pointer to an element.
+
+				//=== Constructor
+				explicit my_basic_iterator(Node * it)
+					: it{it}
+				{/*empty*/}
+
+				/// A my_iterator converts to a my_const_iterator.
+				template< bool Other, typename = std::enable_if_t< Const and not Other > >
+				my_basic_iterator( const my_basic_iterator< Other > & other )
+					: it{ other.getIt() }
+				{/*empty*/}
+
+				//=== Operators
+				iterator operator++(void)
+				{
+					it = it->next;
+					return iterator( it );
+				}
+
+				iterator operator++(int)
+				{
+					iterator temp( it );
+					it = it->next;
+					return temp;
+				}
+
+				iterator operator--(void)
+				{
+					it = it->prev;
+					return iterator( it );
+				}
+
+				iterator operator--(int)
+				{
+					iterator temp( it );
+					it = it->prev;
+					return temp;
+				}
+
+				reference operator*() const
+				{ return it->data; }
+
+				pointer operator->() const
+				{ return &it->data; }
+
+				bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+
+				Node * getIt() const
+				{ return it; }
+
+		}; // class my_basic_iterator
+
+	}; // class hashed_list
+
+} // namespace sc
+
+#endif
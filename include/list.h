@@ -1,238 +1,326 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "list_node.h"
+#ifdef SC_LIST_PROFILE
+#include "traversal_profiler.h"
+#endif
 
 /*! \namespace sc
     \brief namespace to differ from std
 */
 namespace sc{
 
+	class node_reclaimer; // node_reclaimer.h, needed by clear_async() only.
+
 
 	/*! \class list
     	\brief means like std::vector
 
     	With this class we try to implement our own vector, but with linked lists.
+    	Layout picks how the nodes are laid out, see list_node.h: data_first (the
+    	default), links_first, cache_aligned, or out_of_line for large elements.
 	*/
-	template< typename T >
+	template< typename T, typename Allocator = std::allocator< T >, typename Layout = data_first >
 	class list{
 		private:
 			//=== Alias
 			typedef size_t size_type; //!< Type of size.
+			typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
 			static constexpr size_type initial_size=0; //!< Default value is 0.
+			static constexpr size_type default_batch=4096; //!< Elements linked at once by append_from().
+			static constexpr size_type read_buffer_size=1 << 16; //!< Bytes read at once by append_from( fd ).
+#ifdef SC_LIST_ORDER_LABELS
+			typedef unsigned long long label_type; //!< Type of the order-maintenance labels.
+			static constexpr unsigned label_bits=63; //!< Labels live in [0, 2^label_bits).
+			static constexpr label_type label_step=label_type{1} << 24; //!< Gap between labels appended at the ends.
+#endif
+#ifdef SC_LIST_PROFILE
+			typedef traced< size_type > index_type; //!< Index remembering its call site.
+			typedef traced< int > offset_type; //!< Iterator offset remembering its call site.
+#else
+			typedef size_type index_type; //!< Type of an index.
+			typedef int offset_type; //!< Type of an iterator offset.
+#endif
 
 			//=== Attributes
-			struct Node{
-				T data;
-				Node* next;
-				Node* prev;
-			};
+#ifdef SC_LIST_ORDER_LABELS
+			typedef list_node< T, Layout, label_type > Node; //!< Node laid out as Layout says.
+#else
+			typedef list_node< T, Layout, no_label > Node; //!< Node laid out as Layout says.
+#endif
+			typedef std::integral_constant< bool, std::is_same< Layout, out_of_line >::value > separate_payload; //!< Whether the elements are allocated apart.
 
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< Node > node_allocator; //!< Allocates the nodes.
+			typedef std::allocator_traits< node_allocator > node_traits; //!< Interface of node_allocator.
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< T > payload_allocator; //!< Allocates the payload_arena of out_of_line nodes.
+			typedef std::allocator_traits< payload_allocator > payload_traits; //!< Interface of payload_allocator.
+
+			[[no_unique_address]] node_allocator m_alloc; //!< Source of every node, the sentinels included.
 			size_type m_size; //!< size of the list.
 			Node * head; //!< Head Node pointer.
 			Node * tail; //!< Tail Node pointer.
+			Node * m_garbage; //!< Detached nodes waiting to be released by clear_some().
+			Node * m_free; //!< Spare nodes linked through next, reused before allocating.
+			size_type m_spare; //!< Number of spare nodes in m_free.
+#ifdef SC_LIST_PROFILE
+			size_type m_hops = 0; //!< Nodes walked by operator[] and at() on this list.
+#endif
 
 
 		public:
 			class my_iterator;
+			class my_const_iterator;
+
+			//=== Standard container alias
+			typedef T value_type; //!< Type of the elements.
+			typedef T & reference; //!< Reference to an element.
+			typedef const T & const_reference; //!< Read-only reference to an element.
+			typedef my_iterator iterator; //!< Bidirectional iterator.
+			typedef my_const_iterator const_iterator; //!< Read-only bidirectional iterator.
+			typedef Allocator allocator_type; //!< Allocator the nodes are obtained from, rebound to them.
+			typedef Layout layout_type; //!< Layout of the nodes.
+			static constexpr size_t node_bytes=sizeof( Node ); //!< Bytes per node, out_of_line elements not included.
 
 			//=== Constructors
 			/// Default constructor.
-			list( )
-				: m_size{initial_size}, head{new Node}, tail{new Node}
+			constexpr list( )
+				: m_size{initial_size}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
 			{
-				head->next = tail;
-				head->prev = nullptr;
-				tail->prev = head;
-				tail->next = nullptr;
+				init_sentinels();
+			}
+
+			/// Empty list allocating its nodes from alloc.
+			constexpr explicit list( const Allocator & alloc )
+				: m_alloc( alloc ), m_size{initial_size}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
+			{
+				init_sentinels();
 			}
 
 			/// Constructor with a defined capacity.
-			explicit list( size_type count )
-				: m_size{count}, head{new Node}, tail{new Node}
+			constexpr explicit list( size_type count )
+				: m_size{count}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
 			{	
-				head->prev = nullptr;
-				tail->next = nullptr;
+				init_sentinels();
 
-				Node * fast = head;
-				Node * temp;
 				for(size_type i{0u} ; i < count ; i++)
 				{
-					temp = new Node;
-					temp->data = 0;
-
-					fast->next = temp;
-					temp->prev = fast;
-
-					fast = fast->next;
+					link_before( tail, create_node() );
 				}
-
-				tail->prev = fast;
-				fast->next = tail;
 			}
 			
-			/// Constructor with elements in [first, last) range.
+			/// Constructor with elements in [first, last) range. Single pass, so any input iterator works.
 			template< typename InputIt >
-			list( InputIt first, InputIt last )
-				: m_size{(size_type)(last - first)}, head{new Node}, tail{new Node}
+			constexpr list( InputIt first, InputIt last )
+				: m_size{initial_size}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
 			{
-				head->prev = nullptr;
-				tail->next = nullptr;
-				head->next = tail;
-				tail->prev = head;
+				init_sentinels();
 
-				while(first != last)
+				for( ; first != last ; ++first )
 				{
-					tail->next = new Node;
-					tail->next->prev = tail;
-					tail->data = *(first++);
-					tail = tail->next;
-					tail->next = nullptr;
+					link_before( tail, create_node( *first ) );
+					m_size++;
 				}
 			}
 
 			/// Copy constructor.
-			list( const list& other )
-				: m_size{other.size()}, head{new Node}, tail{ new Node }
+			constexpr list( const list& other )
+				: m_alloc( node_traits::select_on_container_copy_construction( other.m_alloc ) ), m_size{other.size()}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
 			{
-				head->prev = nullptr;
-				tail->next = nullptr;
+				init_sentinels();
 
 				Node * otherTemp = other.head->next;
-				Node * temp = head;
 				for( size_type i{0u} ; i < m_size ; i++ )
 				{
-					Node * newNode = new Node;
-					temp->next = newNode;
-					newNode->prev = temp;
-
-					newNode->data = otherTemp->data;
+					link_before( tail, create_node( otherTemp->value() ) );
 
 					otherTemp = otherTemp->next;
-					temp = temp->next;
 				}
+			}
 
-				temp->next = tail;
-				tail->prev = temp;
+			/// Move constructor, takes the nodes of other and leaves it empty.
+			constexpr list( list&& other )
+				: m_alloc( other.m_alloc ), m_size{initial_size}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
+			{
+				init_sentinels();
+				take_elements( other );
 			}
 
 			/// std::initializer_list copy constructor.
-			list( std::initializer_list<T> ilist )
-				: m_size{ilist.size()}, head{new Node}, tail{new Node}
+			constexpr list( std::initializer_list<T> ilist )
+				: m_size{ilist.size()}, head{new_sentinel()}, tail{new_sentinel()}, m_garbage{nullptr}, m_free{nullptr}, m_spare{0}
 			{
-				head->prev = nullptr;
-				tail->next = nullptr;
-				head->next = tail;
-				tail->prev = head;
+				init_sentinels();
 
 				for( const T& e : ilist )
 				{
-						tail->next = new Node;
-						tail->next->prev = tail;
-						tail->data = e;
-						tail = tail->next;
-						tail->next = nullptr;
+					link_before( tail, create_node( e ) );
 				}
 			}
 
 			/// Destructor.
-			~list( )
+			constexpr ~list( )
 			{
-				while( tail != head )
-				{
-					tail = tail->prev;
-					delete tail->next;
-				}
-				delete head;
+				release_chain( m_alloc, detach_chain( m_garbage ) );
+				shrink_to_fit();
+
+				free_node( m_alloc, head );
+				free_node( m_alloc, tail );
 			}
 
 			//=== Iterators
 			/// Returns an iterator pointing to the first item in the list.
-			my_iterator begin()
+			constexpr my_iterator begin()
 			{
 				my_iterator iter(head->next);
 				return iter;
 			}
 
 			/// Returns a iterator pointing to the position just after the last item in the list.
-			my_iterator end()
+			constexpr my_iterator end()
 			{
 				my_iterator iter(tail);
 				return iter;
 			}
 
 			/// Returns a constant iterator pointing to the first element of the list.
-			const my_iterator cbegin() const
-			{
-				my_const_iterator iter(head->next);
-				return iter;
-			}
+			constexpr my_const_iterator begin() const
+			{ return my_const_iterator( head->next ); }
 
 			/// Returns a constant iterator pointing to the position just after the last element of the list.
-			const my_iterator cend() const
-			{
-				my_const_iterator iter(tail);
-				return iter;
-			}
+			constexpr my_const_iterator end() const
+			{ return my_const_iterator( tail ); }
+
+			/// Returns a constant iterator pointing to the first element of the list.
+			constexpr my_const_iterator cbegin() const
+			{ return my_const_iterator( head->next ); }
+
+			/// Returns a constant iterator pointing to the position just after the last element of the list.
+			constexpr my_const_iterator cend() const
+			{ return my_const_iterator( tail ); }
 
 
 	// 	public:
 			//=== Methods
 			/// Returns the size of the list.
-			size_type size( ) const
+			constexpr size_type size( ) const
 			{return this->m_size;}
 
-			/// Delete all array elements.
-			void clear( )
+			/// Returns a copy of the allocator.
+			allocator_type get_allocator( ) const
+			{ return allocator_type( m_alloc ); }
+
+			/// Returns the number of elements the list can hold before allocating new nodes.
+			constexpr size_type capacity( ) const
+			{return m_size + m_spare;}
+
+			/// Preallocates spare nodes until the list can hold new_cap elements without allocating.
+			/// The spare nodes hold no element, so T needs no default constructor.
+			constexpr void reserve( size_type new_cap )
+			{
+				while( capacity() < new_cap )
+					keep_spare( new_node() );
+			}
+
+			/// Frees the spare nodes, capacity() becomes size().
+			constexpr void shrink_to_fit( )
 			{
-				while( tail != head )
+				while( m_free != nullptr )
 				{
-					tail = tail->prev;
-					delete tail->next;
+					Node * target = m_free;
+					m_free = m_free->next;
+					free_node( m_alloc, target );
 				}
-				delete head;
+				m_spare = 0;
+			}
+
+			/// Delete all array elements.
+			constexpr void clear( )
+			{
+				release_chain( m_alloc, detach_chain( m_garbage ) );
+				m_garbage = nullptr;
+			}
 
-				this->m_size = initial_size;
+			/// Empties the list in O(1) and lets the background reclaimer free the nodes, or frees them here
+			/// once the reclaimer has shut down. Needs node_reclaimer.h.
+			template< typename Reclaimer = node_reclaimer >
+			void clear_async( )
+			{
+				static_assert( std::allocator_traits< Allocator >::is_always_equal::value,
+					"clear_async() frees the nodes with another instance of the allocator" );
 
-				head = new Node;
-				tail = new Node;
+				Node * chain = detach_chain( m_garbage );
+				m_garbage = nullptr;
 
-				head->next = tail;
-				head->prev = nullptr;
-				tail->prev = head;
-				tail->next = nullptr;
+				if( chain != nullptr )
+					Reclaimer::dispose( chain, &release_detached );
+			}
+
+			/// Empties the list in O(1) and frees at most budget of its nodes; the rest is freed by the next calls.
+			/// Returns true when no detached node is left to free.
+			constexpr bool clear_some( size_type budget )
+			{
+				m_garbage = detach_chain( m_garbage );
+
+				for( ; budget > 0 and m_garbage != nullptr ; budget-- )
+				{
+					Node * target = m_garbage;
+					m_garbage = m_garbage->next;
+					delete_node( target );
+				}
+
+				return m_garbage == nullptr;
 			}
 
 			/// Checks if the array is empty.
-			bool empty( )
+			constexpr bool empty( )
 			{return m_size == 0;}
 			
 			/// Adds value to the front of the list.
-			void push_front( const T & value )
+			constexpr void push_front( const T & value )
 			{
-				head->data = value;
-				head->prev = new Node;
-				head->prev->next = head;
-				head = head->prev;
-				head->prev = nullptr;
+				link_before( head->next, create_node( value ) );
+
+				m_size++;
+			}
+
+			constexpr void push_front( T && value )
+			{
+				link_before( head->next, create_node( std::move( value ) ) );
+
 				m_size++;
 			}
 
 			/// Adds value to the end of the list.
-			void push_back( const T & value )
+			constexpr void push_back( const T & value )
 			{	
-				tail->data = value;
-				tail->next = new Node;
-				tail->next->prev = tail;
-				tail = tail->next;
-				tail->next = nullptr;
+				link_before( tail, create_node( value ) );
+
+				m_size++;
+			}
+
+			constexpr void push_back( T && value )
+			{
+				link_before( tail, create_node( std::move( value ) ) );
+
 				m_size++;
 			}
 			
 			/// Removes the object at the end of the list.
-			void pop_back( )
+			constexpr void pop_back( )
 			{
 				if(m_size == 0)
 					return;
@@ -241,13 +329,13 @@ namespace sc{
 				tail->prev = target->prev;
 				tail->prev->next = tail;
 
-				delete target;
+				recycle_node( target );
 
 				m_size--;
 			}
 
 			/// Removes the object at the front of the list.
-			void pop_front( )
+			constexpr void pop_front( )
 			{
 				if(m_size == 0)
 					return;
@@ -256,169 +344,161 @@ namespace sc{
 				head->next = target->next;
 				target->next->prev = head;
 
-				delete target;
+				recycle_node( target );
 
 				m_size--;
 			}
 
 			/// Returns the object at the end of the list.
-			const T & back( ) const
+			constexpr const T & back( ) const
 			{
-				return tail->prev->data;
+				return tail->prev->value();
 			}
 
 			/// Returns the object at the beginning of the list.
-			const T & front( ) const
+			constexpr const T & front( ) const
 			{
-				return head->next->data;
+				return head->next->value();
 			}
 
 			/// Replaces the content of the list with copies of value.
-			void assign( const T & value )
+			constexpr void assign( const T & value )
 			{
 				Node * fast = head->next;
 				for( size_type i{0u} ; i<m_size ; i++ )
 				{
-					fast->data = value;
+					fast->value() = value;
 					fast = fast->next;
 				}
 			}
 
-			/// Return the object at the index position.
-			T & operator[]( size_type pos )
-			{ 
-				if( pos >= m_size )
-					return nullptr;
-
-				Node * fast = head->next;
-				for( size_type i{0u} ; i < pos ; i++ )
-					fast = fast->next;
-
-				return fast->data;
+			/// Return the object at the index position. Walks pos nodes and, like std::vector, doesn't check pos.
+			constexpr T & operator[]( index_type pos )
+			{
+				profile_walk( pos, untraced( pos ) );
+				return node_at( untraced( pos ) )->value();
 			}
 
 			/// Returns the object at the index pos in the array.
-			T & at( size_type pos )
+			constexpr T & at( index_type pos )
 			{
-				if( not (pos < m_size and pos >= 0) )
+				if( not ( untraced( pos ) < m_size ) )
 					throw std::out_of_range("error in at(): out of range");
-				else
-				{
-					Node * fast = head->next;
-					for( size_type i{0u} ; i < pos ; i++ )
-						fast = fast->next;
 
-					return fast->data;
-				}
-			}		
+				profile_walk( pos, untraced( pos ) );
+				return node_at( untraced( pos ) )->value();
+			}
+
+#ifdef SC_LIST_PROFILE
+			/// Returns the number of nodes walked by operator[] and at() on this list.
+			size_type traversal_hops( ) const
+			{ return m_hops; }
+#endif
 
 			//=== Operators overload
 			/// Operator= overload for vectors
-			list& operator=( const list& other )
+			constexpr list& operator=( const list& other )
 			{
 				Node * fast = head->next;
 				Node * otherTemp = other.head->next;
 				for( size_type i{0u} ; i < other.size() ; i++ )
 				{
 					if( fast == tail )
+						link_before( tail, create_node( otherTemp->value() ) );
+					else
 					{
-						tail->next = new Node;
-						tail->next->prev = tail;
-						tail = tail->next;
-						tail->next = nullptr;
+						fast->value() = otherTemp->value();
+						fast = fast->next;
 					}
 
-					fast->data = otherTemp->data;
-					
-					fast = fast->next;
 					otherTemp = otherTemp->next;
 				}
 
+				// The extra nodes are kept as spare capacity.
+				erase( my_iterator( fast ), end() );
 				this->m_size = other.size();
 
 				return *this;
 			}
 
+			/// Takes the elements of other and leaves it empty. Their nodes are taken when both lists have equal
+			/// allocators or other's propagates, otherwise the elements are moved one by one. The nodes of this
+			/// list are kept as spare capacity, unless its allocator is replaced by a different one.
+			constexpr list& operator=( list&& other )
+			{
+				if( this != &other )
+				{
+					if( m_alloc == other.m_alloc )
+					{
+						erase( begin(), end() );
+						take_elements( other );
+					}
+					else
+						move_assign( other, typename node_traits::propagate_on_container_move_assignment() );
+				}
+
+				return *this;
+			}
+
 			/// Operator= overload for initializer_list
-			list& operator=( std::initializer_list<T> ilist )
+			constexpr list& operator=( std::initializer_list<T> ilist )
 			{
 				Node * fast = head->next;
 				for( const T& e : ilist)
 				{
 					if( fast == tail )
+						link_before( tail, create_node( e ) );
+					else
 					{
-						tail->next = new Node;
-						tail->next->prev = tail;
-						tail = tail->next;
-						tail->next = nullptr;
+						fast->value() = e;
+						fast = fast->next;
 					}
-
-					fast->data = e;
-					
-					fast = fast->next;
 				}
 
+				// The extra nodes are kept as spare capacity.
+				erase( my_iterator( fast ), end() );
 				this->m_size = ilist.size();
 
 				return *this;
 			}
 
 			/// Operator== overload for vectors comparison
-			bool operator==( const list& rhs )
+			constexpr bool operator==( const list& rhs ) const
 			{
-				if( m_size == rhs.size() )
+				if( m_size != rhs.size() )
+					return false;
+
+				Node * mine = head->next;
+				Node * theirs = rhs.head->next;
+				for( size_type i{0u} ; i < m_size ; i++ )
 				{
-					Node* temp;
-					temp = rhs.head->next;
-					tail = head->next;
-					for( size_type i{0u} ; i < m_size ; i++ )
-					{
-						if(tail->data != temp->data) return false;
-						else
-						{
-							tail = tail->next;
-							temp = temp->next;
-						}
-					}
-					return true;
+					if( mine->value() != theirs->value() )
+						return false;
+
+					mine = mine->next;
+					theirs = theirs->next;
 				}
-				else return false;
+				return true;
 			}
 
 			/// Operator!= overload for vectors comparison
-			bool operator!=( const list& rhs )
-			{
-				if( this->m_size == rhs.size() )
-				{
-					Node* temp;
-					temp = rhs.head->next;
-					tail = head->next;
-					for(int i=0; i<(int)this->m_size; i++)
-					{
-						if(tail->data != temp->data) return true;
-						else
-						{
-							tail = tail->next;
-							temp = temp->next;
-						}
-					}
-					return false;
-				}
-				else return true;
-			}
+			constexpr bool operator!=( const list& rhs ) const
+			{ return not ( *this == rhs ); }
 
 			//=== Operations
 			/// Adds value into the list before pos. Returns an iterator to the position of the inserted item.
-			my_iterator insert ( my_iterator pos, const T & value )
+			constexpr my_iterator insert ( my_iterator pos, const T & value )
 			{
-				Node * temp = pos.getIt();
-				Node * newNode = new Node;
+				link_before( pos.getIt(), create_node( value ) );
+
+				m_size++;
+
+				return pos;
+			}
 
-				newNode->data = value;
-				newNode->next = temp;
-				newNode->prev = temp->prev;
-				temp->prev = newNode;
-				newNode->prev->next = newNode;
+			constexpr my_iterator insert ( my_iterator pos, T && value )
+			{
+				link_before( pos.getIt(), create_node( std::move( value ) ) );
 
 				m_size++;
 
@@ -427,51 +507,114 @@ namespace sc{
 
 			///inserts elements from the range [first; last) before pos.
 			template< typename InItr >
-			my_iterator insert( my_iterator pos, InItr first, InItr last )
+			constexpr my_iterator insert( my_iterator pos, InItr first, InItr last )
 			{
 				Node * it = pos.getIt();
-				Node * fast = it;
-				fast = fast->prev;
 
 				while( first != last )
 				{
-					fast->next = new Node;
-					fast->next->data = *(first++);
-					fast->next->prev = fast;
-					fast = fast->next;
+					link_before( it, create_node( *(first++) ) );
 					m_size++;
 				}
 
-				fast->next = it;
-				it->prev = fast;
-
 				return pos;
 			}
 
 			/// Inserts elements from the initializer list ilist before pos.
-			my_iterator insert( my_iterator pos, std::initializer_list< T > ilist )
+			constexpr my_iterator insert( my_iterator pos, std::initializer_list< T > ilist )
 			{
 				Node * it = pos.getIt();
-				Node * fast = it;
-				fast = fast->prev;
 
 				for( const T& e : ilist )
 				{
-					fast->next = new Node;
-					fast->next->data = e;
-					fast->next->prev = fast;
-					fast = fast->next;
+					link_before( it, create_node( e ) );
 					m_size++;
 				}
 
-				fast->next = it;
-				it->prev = fast;
-
 				return pos;
 			}
 
+			/// Moves the element at it from other to just before pos, relinking its node. it stays valid.
+			/// Like std::list, other must have an allocator equal to this list's one: the nodes keep theirs.
+			constexpr void splice( my_iterator pos, list & other, my_iterator it )
+			{
+				assert( splice_allowed( other ) );
+				Node * target = it.getIt();
+				if( target == pos.getIt() )
+					return;
+
+				target->next->prev = target->prev;
+				target->prev->next = target->next;
+				other.m_size--;
+
+				link_before( pos.getIt(), target );
+				m_size++;
+			}
+
+			/// Moves all the elements of other to just before pos, relinking their nodes. other becomes empty.
+			/// other must have an allocator equal to this list's one.
+			constexpr void splice( my_iterator pos, list & other )
+			{
+				assert( splice_allowed( other ) );
+				if( &other == this or other.m_size == 0 )
+					return;
+
+#ifdef SC_LIST_ORDER_LABELS
+				while( other.m_size > 0 )
+					splice( pos, other, other.begin() );
+#else
+				Node * first = other.head->next;
+				Node * last = other.tail->prev;
+				other.head->next = other.tail;
+				other.tail->prev = other.head;
+
+				Node * temp = pos.getIt();
+				first->prev = temp->prev;
+				temp->prev->next = first;
+				last->next = temp;
+				temp->prev = last;
+
+				m_size += other.m_size;
+				other.m_size = initial_size;
+#endif
+			}
+
+			/// Moves the elements of other in [first; last) to just before pos, relinking their nodes.
+			/// Linear in the number of moved elements, they have to be counted. other must have an allocator equal
+			/// to this list's one.
+			constexpr void splice( my_iterator pos, list & other, my_iterator first, my_iterator last )
+			{
+				assert( splice_allowed( other ) );
+				if( first == last )
+					return;
+
+#ifdef SC_LIST_ORDER_LABELS
+				while( first != last )
+					splice( pos, other, first++ );
+#else
+				Node * begin = first.getIt();
+				Node * end = last.getIt();
+				Node * back = begin;
+				size_type count = 1;
+				for( ; back->next != end ; back = back->next )
+					count++;
+
+				begin->prev->next = end;
+				end->prev = begin->prev;
+
+				Node * temp = pos.getIt();
+				begin->prev = temp->prev;
+				temp->prev->next = begin;
+				back->next = temp;
+				temp->prev = back;
+
+				other.m_size -= count;
+				m_size += count;
+#endif
+			}
+
 			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
-			my_iterator erase( my_iterator pos )
+			constexpr my_iterator erase( my_iterator pos )
 			{
 				Node * target = pos.getIt();
 				pos++;
@@ -479,7 +622,7 @@ namespace sc{
 				target->next->prev = target->prev;
 				target->prev->next = target->next;
 
-				delete target;
+				recycle_node( target );
 
 				m_size--;
 
@@ -487,7 +630,7 @@ namespace sc{
 			}
 
 			/// Removes elements in the range [first; last).
-			my_iterator erase( my_iterator ifirst, my_iterator ilast )
+			constexpr my_iterator erase( my_iterator ifirst, my_iterator ilast )
 			{
 				Node * first = ifirst.getIt();
 				Node * last = ilast.getIt();
@@ -500,280 +643,1138 @@ namespace sc{
 					first->prev = target->prev;
 					target->prev->next = first;
 
-					delete target;
+					recycle_node( target );
 
 					m_size--;
 				}
 
-				return last;
+				return my_iterator( last );
 			}
 
-			/// Replaces the contents with count copies of value value.
-			template< typename InItr >
-			void assign( InItr first, InItr last )
+			/// Reads elements with is >> value until it fails and appends them. Returns the number of appended elements.
+			size_type append_from( std::istream & is, size_type batch_size = default_batch )
 			{
-				Node * fast = head->next;
-
-				while( first != last and fast != tail )
-				{
-					fast->data = *(first++);
-					fast = fast->next;
-				}
+				return append_from( is, []( std::istream & in, T & value ){ return bool( in >> value ); }, batch_size );
 			}
 
-			/// Replaces the contents of the list with copies of the elements in the range [first; last).
-			void assign( std::initializer_list< T > ilist )
+			/// Appends the elements read by parser( is, value ) until it returns false. Elements are parsed straight
+			/// into nodes and linked batch_size at a time. Returns the number of appended elements.
+			/// If parser throws, nothing is appended: the batches linked by this call are removed again.
+			template< typename Parser, typename = typename std::enable_if< not std::is_integral< Parser >::value >::type >
+			size_type append_from( std::istream & is, Parser parser, size_type batch_size = default_batch )
 			{
-				Node * fast = head->next;
+				if( batch_size == 0 )
+					throw std::invalid_argument("error in append_from(): batch_size must be positive");
 
-				for( const T& e : ilist )
+				Node * before = tail->prev;
+				size_type total = 0;
+				bool done = false;
+				batch_chain batch;
+
+				try
 				{
-					if( fast == tail )
-						break;
+					while( not done )
+					{
+						while( batch.count < batch_size )
+						{
+							Node * node = create_node();
+							bool parsed;
+							try {
+								parsed = parser( is, node->value() );
+							} catch( ... ) {
+								recycle_node( node );
+								throw;
+							}
+							if( not parsed )
+							{
+								recycle_node( node );
+								done = true;
+								break;
+							}
+							batch.push( node );
+						}
 
-					fast->data = e;
-					fast = fast->next;
+						total += batch.count;
+						link_batch( batch );
+					}
+				}
+				catch( ... )
+				{
+					unappend( before, batch );
+					throw;
 				}
-			}
-			
-			// gift hahaha
-			friend std::ostream& operator<<(std::ostream& os, const list& lf)
-			{
-				Node * temp = lf.head->next;
-			    os << "[ ";
-			    for( size_type i{0u} ; i < lf.size() ; i++ )
-			    {
-			        os << temp->data << " ";
-			        temp = temp->next;
-			    }
-			    os << "]";
 
-			    return os;
-			}	
+				return total;
+			}
 
+			/// Reads the whitespace separated tokens of file descriptor fd until end of file and appends
+			/// parser( token_first, token_last, value ) for each one. Memory is bounded by a fixed read buffer
+			/// and batch_size nodes. Returns the number of appended elements. If reading or parsing fails,
+			/// nothing is appended: the batches linked by this call are removed again.
+			template< typename Parser >
+			size_type append_from( int fd, Parser parser, size_type batch_size = default_batch )
+			{
+				if( batch_size == 0 )
+					throw std::invalid_argument("error in append_from(): batch_size must be positive");
 
-	public:
+				std::vector< char > buffer( read_buffer_size );
+				Node * before = tail->prev;
+				size_type filled = 0;
+				size_type total = 0;
+				bool eof = false;
+				batch_chain batch;
 
-		/*! \class my_iterator
-			
-			With this class we're trying to implement an iterator class for vectors.
-		*/
-		class my_iterator{
-			private:
-				Node * it; //!< Iterator pointer
-				typedef my_iterator iterator; 
+				try
+				{
+					while( not eof )
+					{
+						ssize_t got = ::read( fd, buffer.data() + filled, buffer.size() - filled );
+						if( got < 0 )
+						{
+							if( errno == EINTR )
+								continue;
+							throw std::runtime_error("error in append_from(): read failed");
+						}
+						eof = got == 0;
+						filled += got;
 
-			public:
-				//=== Alias
-				// typedef size_t size_type; //!< Type of size.
-				
-				//=== Constructor
-				my_iterator(Node * it)
-					: it{it}
-				{/*empty*/}
+						const char * fast = buffer.data();
+						const char * last = buffer.data() + filled;
+						while( true )
+						{
+							while( fast != last and std::isspace( static_cast< unsigned char >( *fast ) ) )
+								fast++;
+
+							const char * token = fast;
+							while( fast != last and not std::isspace( static_cast< unsigned char >( *fast ) ) )
+								fast++;
+
+							// A token touching the end of the buffer may continue in the next read.
+							if( token == last or ( fast == last and not eof ) )
+							{
+								fast = token;
+								break;
+							}
+
+							Node * node = create_node();
+							bool parsed;
+							try {
+								parsed = parser( token, fast, node->value() );
+							} catch( ... ) {
+								recycle_node( node );
+								throw;
+							}
+							if( not parsed )
+							{
+								recycle_node( node );
+								throw std::invalid_argument("error in append_from(): invalid token");
+							}
+							batch.push( node );
+
+							if( batch.count == batch_size )
+							{
+								total += batch.count;
+								link_batch( batch );
+							}
+						}
 
-				//=== Destructor
-				~my_iterator()
-				{/*empty*/}
+						filled = last - fast;
+						if( filled == buffer.size() )
+							throw std::length_error("error in append_from(): token larger than the read buffer");
+						std::copy( fast, last, buffer.data() );
+					}
 
-			public:
-				//=== Operators
-				iterator operator++(void)
-				{ 
-					it = it->next;
-					return iterator( it ); 
+					total += batch.count;
+					link_batch( batch );
 				}
-
-				iterator operator++(int)
-				{ 
-					iterator temp( it );
-					it = it->next;
-					return temp;
+				catch( ... )
+				{
+					unappend( before, batch );
+					throw;
 				}
 
-				T operator*()
-				{ return it->data; }
+				return total;
+			}
 
-				iterator operator--(void)
-				{ 
-					it = it->prev;
-					return iterator( it ); 
-				}
+			/// Removes all the elements equal to value. Returns the number of removed elements.
+			constexpr size_type remove( const T & value )
+			{
+				return remove_if( [&value]( const T & e ){ return e == value; } );
+			}
 
-				iterator operator--(int)
-				{
-					iterator temp( it );
-					it = it->prev;
-					return temp;
-				}
+			/// Removes all the elements for which p returns true, in a single pass. Returns the number of removed elements.
+			template< typename UnaryPredicate >
+			constexpr size_type remove_if( UnaryPredicate p )
+			{
+				// Dead nodes are only released after the pass: p (or remove's value) may refer to one of them.
+				Node * dead = nullptr;
+				size_type count = 0;
 
-				friend iterator operator+(int n, iterator it)
+				Node * fast = head->next;
+				while( fast != tail )
 				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->next;
-					return iterator( it );
-				}
+					Node * target = fast;
+					fast = fast->next;
 
-				friend iterator operator+(iterator it, int n)
-				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->next;
-					return iterator( it );
-				}
+					if( p( target->value() ) )
+					{
+						target->prev->next = fast;
+						fast->prev = target->prev;
+
+						target->next = dead;
+						dead = target;
+						count++;
+					}
+				}
+
+				m_size -= count;
+				recycle_chain( dead );
+
+				return count;
+			}
+
+			/// Removes all consecutive duplicate elements. Returns the number of removed elements.
+			constexpr size_type unique( )
+			{
+				return unique( []( const T & a, const T & b ){ return a == b; } );
+			}
+
+			/// Removes all consecutive elements for which p( kept, current ) returns true. Returns the number of removed elements.
+			template< typename BinaryPredicate >
+			constexpr size_type unique( BinaryPredicate p )
+			{
+				if( m_size < 2 )
+					return 0;
+
+				Node * dead = nullptr;
+				size_type count = 0;
 
-				friend iterator operator-(int n, iterator it)
+				Node * kept = head->next;
+				Node * fast = kept->next;
+				while( fast != tail )
 				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->prev;
-					return iterator( it );
+					Node * target = fast;
+					fast = fast->next;
+
+					if( p( kept->value(), target->value() ) )
+					{
+						kept->next = fast;
+						fast->prev = kept;
+
+						target->next = dead;
+						dead = target;
+						count++;
+					}
+					else
+						kept = target;
 				}
 
-				friend iterator operator-(iterator it, int n)
+				m_size -= count;
+				recycle_chain( dead );
+
+				return count;
+			}
+
+			/// Sorts the elements in ascending order. Stable, only relinks the nodes.
+			constexpr void sort( )
+			{
+				sort( []( const T & a, const T & b ){ return a < b; } );
+			}
+
+			/// Sorts the elements by comp, a strict weak ordering. Stable, only relinks the nodes,
+			/// so iterators stay valid and follow their elements.
+			template< typename Compare >
+			constexpr void sort( Compare comp )
+			{
+				if( m_size < 2 )
+					return;
+
+				// Bottom-up merge sort: bins[i] holds a sorted chain of 2^i nodes, older nodes in higher bins.
+				Node * bins[64] = {};
+				size_type filled = 0;
+
+				Node * fast = head->next;
+				tail->prev->next = nullptr;
+				while( fast != nullptr )
 				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->prev;
-					return iterator( it );
+					Node * carry = fast;
+					fast = fast->next;
+					carry->next = nullptr;
+
+					size_type i = 0;
+					for( ; i < filled and bins[i] != nullptr ; i++ )
+					{
+						carry = merge_chains( bins[i], carry, comp );
+						bins[i] = nullptr;
+					}
+					bins[i] = carry;
+					if( i == filled )
+						filled++;
 				}
 
-				friend size_type operator-(iterator it1, iterator it2)
+				Node * sorted = nullptr;
+				for( size_type i{0u} ; i < filled ; i++ )
+				{
+					if( bins[i] != nullptr )
+						sorted = merge_chains( bins[i], sorted, comp );
+				}
+
+				// Relinks in order, which also fixes prev and the labels.
+				head->next = tail;
+				tail->prev = head;
+				while( sorted != nullptr )
+				{
+					Node * target = sorted;
+					sorted = sorted->next;
+					link_before( tail, target );
+				}
+			}
+
+			/// Reverses the order of the elements by relinking the nodes. Nothing is copied,
+			/// iterators stay valid and follow their elements.
+			constexpr void reverse( )
+			{
+				if( m_size < 2 )
+					return;
+
+				Node * first = head->next;
+				Node * last = tail->prev;
+				for( Node * fast = first ; fast != tail ; )
 				{
-					size_t count = 0;
-					while( it2 != it1 )
+					Node * node = fast;
+					fast = fast->next;
+					std::swap( node->next, node->prev );
+				}
+
+				head->next = last;
+				last->prev = head;
+				tail->prev = first;
+				first->next = tail;
+#ifdef SC_LIST_ORDER_LABELS
+				relabel();
+#endif
+			}
+
+			/// Makes middle the first element, the ones before it follow the last one, in O(1) by relinking
+			/// (O(size()) with order labels). Returns an iterator to the element that was first, or end() if middle was begin().
+			constexpr my_iterator rotate( my_iterator middle )
+			{
+				Node * pivot = middle.getIt();
+				Node * first = head->next;
+				if( pivot == first )
+					return end();
+				if( pivot == tail )
+					return begin();
+
+				Node * last = tail->prev;
+				Node * before = pivot->prev;
+
+				head->next = pivot;
+				pivot->prev = head;
+				last->next = first;
+				first->prev = last;
+				before->next = tail;
+				tail->prev = before;
+#ifdef SC_LIST_ORDER_LABELS
+				relabel();
+#endif
+
+				return my_iterator( first );
+			}
+
+			/// Moves the elements for which p returns true before the others, by relinking the nodes.
+			/// Relinking keeps the relative order for free, so this is stable_partition( p ).
+			template< typename UnaryPredicate >
+			constexpr my_iterator partition( UnaryPredicate p )
+			{
+				return stable_partition( p );
+			}
+
+			/// Moves the elements for which p returns true before the others, keeping their relative order.
+			/// Nothing is copied or allocated, iterators follow their elements. Returns an iterator to the first
+			/// element of the second group, or end(). If p throws, the elements already rejected end up last.
+			template< typename UnaryPredicate >
+			constexpr my_iterator stable_partition( UnaryPredicate p )
+			{
+				// The rejected nodes are unlinked into a chain, then linked back before the tail.
+				Node * rejected = nullptr;
+				Node * last_rejected = nullptr;
+
+				try {
+					for( Node * fast = head->next ; fast != tail ; )
 					{
+						Node * node = fast;
+						fast = fast->next;
+						if( p( node->value() ) )
+							continue;
+
+						node->prev->next = node->next;
+						node->next->prev = node->prev;
+
+						node->prev = last_rejected;
+						node->next = nullptr;
+						if( last_rejected == nullptr )
+							rejected = node;
+						else
+							last_rejected->next = node;
+						last_rejected = node;
+					}
+				} catch( ... ) {
+					append_chain( rejected, last_rejected );
+					throw;
+				}
+
+				append_chain( rejected, last_rejected );
+
+				return my_iterator( rejected != nullptr ? rejected : tail );
+			}
+
+			/// Replaces the contents with count copies of value value.
+			template< typename InItr >
+			constexpr void assign( InItr first, InItr last )
+			{
+				Node * fast = head->next;
+
+				while( first != last and fast != tail )
+				{
+					fast->value() = *(first++);
+					fast = fast->next;
+				}
+			}
+
+			/// Replaces the contents of the list with copies of the elements in the range [first; last).
+			constexpr void assign( std::initializer_list< T > ilist )
+			{
+				Node * fast = head->next;
+
+				for( const T& e : ilist )
+				{
+					if( fast == tail )
+						break;
+
+					fast->value() = e;
+					fast = fast->next;
+				}
+			}
+			
+			// gift hahaha
+			friend std::ostream& operator<<(std::ostream& os, const list& lf)
+			{
+				Node * temp = lf.head->next;
+			    os << "[ ";
+			    for( size_type i{0u} ; i < lf.size() ; i++ )
+			    {
+			        os << temp->value() << " ";
+			        temp = temp->next;
+			    }
+			    os << "]";
+
+			    return os;
+			}	
+
+
+		private:
+			/// Unlinks all the elements in O(1) and returns them as a chain linked through next, followed by rest.
+			constexpr Node * detach_chain( Node * rest )
+			{
+				if( m_size == 0 )
+					return rest;
+
+				Node * first = head->next;
+				Node * last = tail->prev;
+				last->next = rest;
+
+				head->next = tail;
+				tail->prev = head;
+				m_size = initial_size;
+
+				return first;
+			}
+
+			/// Frees a chain of nodes linked through next, allocated from alloc.
+			constexpr static void release_chain( node_allocator & alloc, Node * dead )
+			{
+				while( dead != nullptr )
+				{
+					Node * target = dead;
+					dead = dead->next;
+					destroy_node( alloc, target );
+				}
+			}
+
+			/// Frees a chain handed over to the node_reclaimer, with an allocator equal to the list's one.
+			static void release_detached( void * chain )
+			{
+				node_allocator alloc;
+				release_chain( alloc, static_cast< Node * >( chain ) );
+			}
+
+			/// Allocates a node without an element, ready to take one in create_node().
+			constexpr Node * new_node( )
+			{
+				return new_node( separate_payload() );
+			}
+
+			constexpr Node * new_node( std::false_type )
+			{
+				return new_sentinel();
+			}
+
+			/// out_of_line: the node comes with a slot of the payload_arena, which it keeps while spare.
+			constexpr Node * new_node( std::true_type )
+			{
+				static_assert( std::allocator_traits< Allocator >::is_always_equal::value,
+					"out_of_line elements come from an arena shared by every list of T" );
+
+				T * payload = payload_arena< T, payload_allocator >::instance().take();
+				try
+				{
+					Node * node = new_sentinel();
+					node->payload = payload;
+					return node;
+				}
+				catch( ... )
+				{
+					payload_arena< T, payload_allocator >::instance().give( payload );
+					throw;
+				}
+			}
+
+			/// Allocates a node that never holds an element.
+			constexpr Node * new_sentinel( )
+			{
+				Node * node = node_traits::allocate( m_alloc, 1 );
+				node_traits::construct( m_alloc, node );
+				return node;
+			}
+
+			/// Destroys the element of a node and frees it.
+			constexpr void delete_node( Node * node )
+			{
+				destroy_node( m_alloc, node );
+			}
+
+			constexpr static void destroy_node( node_allocator & alloc, Node * node )
+			{
+				payload_allocator payloads( alloc );
+				payload_traits::destroy( payloads, node->storage() );
+				free_node( alloc, node );
+			}
+
+			/// Frees a node holding no element: a spare node or a sentinel.
+			constexpr static void free_node( node_allocator & alloc, Node * node )
+			{
+				free_node( alloc, node, separate_payload() );
+			}
+
+			constexpr static void free_node( node_allocator & alloc, Node * node, std::false_type )
+			{
+				node_traits::destroy( alloc, node );
+				node_traits::deallocate( alloc, node, 1 );
+			}
+
+			constexpr static void free_node( node_allocator & alloc, Node * node, std::true_type )
+			{
+				if( node->payload != nullptr )
+					payload_arena< T, payload_allocator >::instance().give( node->payload );
+				free_node( alloc, node, std::false_type() );
+			}
+
+			/// Returns the node at index pos.
+			constexpr Node * node_at( size_type pos ) const
+			{
+				Node * fast = head->next;
+				for( size_type i{0u} ; i < pos ; i++ )
+					fast = fast->next;
+
+				return fast;
+			}
+
+#ifdef SC_LIST_PROFILE
+			template< typename N >
+			constexpr static N untraced( traced< N > n )
+			{ return n.value; }
+
+			/// Counts a walk of hops nodes of this list at the call site of pos.
+			constexpr void profile_walk( const index_type & pos, size_type hops )
+			{
+				if( std::is_constant_evaluated() )
+					return;
+
+				m_hops += hops;
+				traversal_profiler::instance().record( pos.where, hops, m_size );
+			}
+
+			/// Counts a walk of hops nodes by iterator arithmetic at the call site of n.
+			constexpr static void profile_walk( const offset_type & n, int hops )
+			{
+				if( not std::is_constant_evaluated() )
+					traversal_profiler::instance().record( n.where, hops, 0 );
+			}
+#else
+			template< typename N >
+			constexpr static N untraced( N n )
+			{ return n; }
+
+			constexpr static void profile_walk( size_type, size_type )
+			{/*empty*/}
+#endif
+
+			/// Merges two sorted chains linked through next, null terminated. On ties the nodes of left come first.
+			template< typename Compare >
+			constexpr static Node * merge_chains( Node * left, Node * right, Compare & comp )
+			{
+				Node * merged = nullptr;
+				Node ** last = &merged;
+				while( left != nullptr and right != nullptr )
+				{
+					if( comp( right->value(), left->value() ) )
+					{
+						*last = right;
+						right = right->next;
+					}
+					else
+					{
+						*last = left;
+						left = left->next;
+					}
+					last = &( *last )->next;
+				}
+				*last = left != nullptr ? left : right;
+
+				return merged;
+			}
+
+			/// Links the chain [first; last), linked both ways, before the tail. Its nodes are already counted in m_size.
+			constexpr void append_chain( Node * first, Node * last )
+			{
+				if( first == nullptr )
+					return;
+
+				first->prev = tail->prev;
+				tail->prev->next = first;
+				last->next = tail;
+				tail->prev = last;
+#ifdef SC_LIST_ORDER_LABELS
+				relabel();
+#endif
+			}
+
+			/// Relinks the elements of other, in order, between the sentinels of this empty list.
+			constexpr void take_elements( list & other )
+			{
+				if( other.m_size == 0 )
+					return;
+
+				Node * first = other.head->next;
+				Node * last = other.tail->prev;
+				head->next = first;
+				first->prev = head;
+				tail->prev = last;
+				last->next = tail;
+				m_size = other.m_size;
+
+				// The sentinels carry the same labels in every list, so the moved nodes keep theirs.
+				other.init_sentinels();
+				other.m_size = 0;
+			}
+
+			/// Move assignment from a list with a different allocator that propagates: the nodes of this list go
+			/// back to its allocator, which other keeps along with them, and this list takes over other's.
+			constexpr void move_assign( list & other, std::true_type )
+			{
+				clear();
+				shrink_to_fit();
+
+				std::swap( m_alloc, other.m_alloc );
+				std::swap( head, other.head );
+				std::swap( tail, other.tail );
+				std::swap( m_size, other.m_size );
+				std::swap( m_garbage, other.m_garbage );
+				std::swap( m_free, other.m_free );
+				std::swap( m_spare, other.m_spare );
+			}
+
+			/// Move assignment from a list with a different allocator that stays: the nodes can't change hands.
+			constexpr void move_assign( list & other, std::false_type )
+			{
+				erase( begin(), end() );
+				for( T & e : other )
+					push_back( std::move( e ) );
+				other.clear();
+			}
+
+			/// Whether the nodes of other may be linked into this list.
+			constexpr bool splice_allowed( const list & other ) const
+			{ return &other == this or m_alloc == other.m_alloc; }
+
+			/// Links the sentinels of an empty list.
+			constexpr void init_sentinels( )
+			{
+				head->next = tail;
+				head->prev = nullptr;
+				tail->prev = head;
+				tail->next = nullptr;
+#ifdef SC_LIST_ORDER_LABELS
+				head->label = 0;
+				tail->label = ( label_type{1} << label_bits ) - 1;
+#endif
+			}
+
+			/// Links node just before pos.
+			constexpr void link_before( Node * pos, Node * node )
+			{
+				node->next = pos;
+				node->prev = pos->prev;
+				pos->prev->next = node;
+				pos->prev = node;
+#ifdef SC_LIST_ORDER_LABELS
+				assign_label( node );
+#endif
+			}
+
+#ifdef SC_LIST_ORDER_LABELS
+			/// Spreads the labels evenly after the nodes were reordered in bulk.
+			constexpr void relabel( )
+			{
+				label_type gap = ( tail->label - head->label ) / ( m_size + 1 );
+				label_type label = head->label;
+				for( Node * fast = head->next ; fast != tail ; fast = fast->next )
+					fast->label = label += gap;
+			}
+
+			/// Gives a freshly linked node a label between its neighbours' ones.
+			constexpr void assign_label( Node * node )
+			{
+				label_type lo = node->prev->label;
+				label_type hi = node->next->label;
+
+				if( hi - lo >= 2 )
+				{
+					// Appends and prepends step by a fixed gap instead of halving the room left at the ends.
+					label_type step = ( hi - lo ) / 2;
+					if( step > label_step and node->next == tail )
+						node->label = lo + label_step;
+					else if( step > label_step and node->prev == head )
+						node->label = hi - label_step;
+					else
+						node->label = lo + step;
+					return;
+				}
+
+				// No room left: find the smallest aligned label range around the node that is
+				// sparse enough, and spread the nodes inside it evenly (Dietz-Sleator/Bender et al.).
+				// A range of 2^i labels may hold up to (2/1.4)^i nodes.
+				double allowed = 1.0;
+				for( unsigned i{1u} ; i <= label_bits ; i++ )
+				{
+					allowed *= 2.0 / 1.4;
+
+					label_type span = label_type{1} << i;
+					label_type base = lo & ~( span - 1 );
+					label_type top = base + ( span - 1 );
+
+					Node * first = node;
+					size_type count = 1;
+					while( first->prev != nullptr and first->prev->label >= base )
+					{
+						first = first->prev;
 						count++;
-						it2++;
 					}
-					return count;
+					for( Node * fast = node->next ; fast != nullptr and fast->label <= top ; fast = fast->next )
+						count++;
+
+					if( count <= allowed )
+					{
+						label_type gap = span / count;
+						label_type label = base;
+						for( size_type j{0u} ; j < count ; j++, first = first->next, label += gap )
+							first->label = label;
+						return;
+					}
 				}
 
-				Node * operator->()
+				throw std::length_error("error in insert(): out of order-maintenance labels");
+			}
+#endif
+
+			/// Nodes parsed by append_from() that are not linked to the list yet.
+			struct batch_chain{
+				Node * first = nullptr;
+				Node * last = nullptr;
+				size_type count = 0;
+
+				constexpr void push( Node * node )
 				{
-					return it;
+					node->next = nullptr;
+					node->prev = last;
+					if( last == nullptr )
+						first = node;
+					else
+						last->next = node;
+					last = node;
+					count++;
 				}
+			};
 
-				bool operator==( const iterator& it2) const
-				{ return it == it2.it; }
+			/// Undoes a failed append: recycles the unlinked batch and removes the nodes linked after before.
+			constexpr void unappend( Node * before, batch_chain & batch )
+			{
+				recycle_chain( batch.first );
+				batch = batch_chain();
+				erase( my_iterator( before->next ), end() );
+			}
 
-				bool operator!=( const iterator& it2) const
-				{ return it != it2.it; }
+			/// Links a batch of nodes before the tail and empties the batch.
+			constexpr void link_batch( batch_chain & batch )
+			{
+				if( batch.count == 0 )
+					return;
 
-				Node * getIt()
-				{ return it; }
+#ifdef SC_LIST_ORDER_LABELS
+				for( Node * fast = batch.first ; fast != nullptr ; )
+				{
+					Node * node = fast;
+					fast = fast->next;
+					link_before( tail, node );
+				}
+#else
+				batch.first->prev = tail->prev;
+				tail->prev->next = batch.first;
+				batch.last->next = tail;
+				tail->prev = batch.last;
+#endif
+				m_size += batch.count;
 
-		}; // class my_iterator
-		
+				batch = batch_chain();
+			}
 
-	// 	// ! \class my_constiterator
-			
-	// 	// 	With this class we're trying to implement an constant iterator class for vectors.
-		
+			/// Returns a node holding an element constructed in place from args, value-initialized when there
+			/// are none. Spare nodes are reused before allocating.
+			template< typename... Args >
+			constexpr Node * create_node( Args &&... args )
+			{
+				Node * node = acquire_node();
+				try
+				{
+					payload_allocator alloc( m_alloc );
+					payload_traits::construct( alloc, node->storage(), std::forward< Args >( args )... );
+				}
+				catch( ... )
+				{
+					keep_spare( node );
+					throw;
+				}
+				return node;
+			}
 
+			/// Returns a spare node, or a new one when there is none. Its element is not constructed.
+			constexpr Node * acquire_node( )
+			{
+				if( m_free == nullptr )
+					return new_node();
 
-		class my_const_iterator{
+				Node * target = m_free;
+				m_free = m_free->next;
+				m_spare--;
+
+				return target;
+			}
+
+			/// Destroys the element of an unlinked node and keeps the node as spare capacity.
+			constexpr void recycle_node( Node * target )
+			{
+				payload_allocator alloc( m_alloc );
+				payload_traits::destroy( alloc, target->storage() );
+				keep_spare( target );
+			}
+
+			/// Keeps a node holding no element as spare capacity.
+			constexpr void keep_spare( Node * target )
+			{
+				target->next = m_free;
+				m_free = target;
+				m_spare++;
+			}
+
+			/// Recycles a chain of unlinked nodes linked through next.
+			constexpr void recycle_chain( Node * dead )
+			{
+				while( dead != nullptr )
+				{
+					Node * target = dead;
+					dead = dead->next;
+					recycle_node( target );
+				}
+			}
+
+			/// Returns the node n nodes after node, or before it when forward is not set.
+			constexpr static Node * step( Node * node, offset_type n, bool forward )
+			{
+				int count = untraced( n );
+				for( int i = 0 ; i < count ; i++ )
+					node = forward ? node->next : node->prev;
+
+				profile_walk( n, count );
+				return node;
+			}
+
+			/// Returns the signed number of steps from node from to node to.
+			constexpr static difference_type distance( const Node * from, const Node * to )
+			{
+#ifdef SC_LIST_ORDER_LABELS
+				if( to->label < from->label )
+					return -distance( to, from );
+
+				difference_type count = 0;
+				for( const Node * fast = from ; fast != to ; fast = fast->next )
+					count++;
+				return count;
+#else
+				// Walks both ways at once, so it stops on whichever side of from to is.
+				const Node * forward = from;
+				const Node * backward = from;
+				difference_type count = 0;
+				while( forward != to and backward != to and ( forward != nullptr or backward != nullptr ) )
+				{
+					count++;
+					if( forward != nullptr )
+						forward = forward->next;
+					if( backward != nullptr )
+						backward = backward->prev;
+				}
+				return forward == to ? count : -count;
+#endif
+			}
+
+	public:
+
+		/*! \class my_iterator
+			
+			Bidirectional iterator over the elements of the list, usable with the standard algorithms and ranges.
+		*/
+		class my_iterator{
 			private:
-				const Node * it; //!< Iterator pointer
-				typedef my_const_iterator iterator; 
+				Node * it; //!< Iterator pointer
+				typedef my_iterator iterator; 
 
 			public:
 				//=== Alias
-				// typedef size_t size_type; //!< Type of size.
+				typedef std::bidirectional_iterator_tag iterator_category; //!< Nodes are linked both ways.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef T * pointer; //!< Pointer to an element.
+				typedef T & reference; //!< Reference to an element.
 				
 				//=== Constructor
-				my_const_iterator(Node * it)
+				/// Singular iterator, only good to be assigned to.
+				constexpr my_iterator()
+					: it{nullptr}
+				{/*empty*/}
+
+				constexpr explicit my_iterator(Node * it)
 					: it{it}
 				{/*empty*/}
 
 				//=== Destructor
-				~my_const_iterator()
+				constexpr ~my_iterator()
 				{/*empty*/}
 
 			public:
 				//=== Operators
-				iterator operator++(void)
+				constexpr iterator & operator++(void)
 				{ 
 					it = it->next;
-					return iterator( it ); 
+					return *this; 
 				}
 
-				iterator operator++(int)
+				constexpr iterator operator++(int)
 				{ 
 					iterator temp( it );
 					it = it->next;
 					return temp;
 				}
 
-				T operator*()
-				{ return it->data; }
+				constexpr reference operator*() const
+				{ return it->value(); }
+
+				constexpr pointer operator->() const
+				{ return &it->value(); }
 
-				iterator operator--(void)
+				constexpr iterator & operator--(void)
 				{ 
 					it = it->prev;
-					return iterator( it ); 
+					return *this; 
 				}
 
-				iterator operator--(int)
+				constexpr iterator operator--(int)
 				{
 					iterator temp( it );
 					it = it->prev;
 					return temp;
 				}
 
-				friend iterator operator+(int n, iterator it)
-				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->next;
-					return iterator( it );
-				}
+				friend constexpr iterator operator+(offset_type n, iterator it)
+				{ return it.moved( n, true ); }
 
-				friend iterator operator+(iterator it, int n)
-				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->next;
-					return iterator( it );
-				}
+				friend constexpr iterator operator+(iterator it, offset_type n)
+				{ return it.moved( n, true ); }
 
-				friend iterator operator-(int n, iterator it)
-				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->prev;
-					return iterator( it );
+				friend constexpr iterator operator-(offset_type n, iterator it)
+				{ return it.moved( n, false ); }
+
+				friend constexpr iterator operator-(iterator it, offset_type n)
+				{ return it.moved( n, false ); }
+
+				/// Returns the signed number of steps from it2 to it1.
+				friend constexpr difference_type operator-(iterator it1, iterator it2)
+				{ return it1.steps_from( it2 ); }
+
+				constexpr bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				constexpr bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+
+#ifdef SC_LIST_ORDER_LABELS
+				/// Checks in O(1) if this iterator comes before it2 in the list.
+				constexpr bool operator<( const iterator& it2) const
+				{ return it->label < it2.it->label; }
+
+				constexpr bool operator>( const iterator& it2) const
+				{ return it2 < *this; }
+
+				constexpr bool operator<=( const iterator& it2) const
+				{ return not ( it2 < *this ); }
+
+				constexpr bool operator>=( const iterator& it2) const
+				{ return not ( *this < it2 ); }
+#endif
+
+				constexpr Node * getIt() const
+				{ return it; }
+
+			private:
+				/// Returns the iterator n nodes away, towards the end when forward is set.
+				constexpr iterator moved( offset_type n, bool forward ) const
+				{ return iterator( step( it, n, forward ) ); }
+
+				/// Returns the signed number of steps from it2 to this iterator.
+				constexpr difference_type steps_from( const iterator & it2 ) const
+				{ return distance( it2.it, it ); }
+
+		}; // class my_iterator
+		
+
+		/*! \class my_const_iterator
+			
+			Bidirectional iterator giving read-only access to the elements. A my_iterator converts to it.
+		*/
+		class my_const_iterator{
+			private:
+				Node * it; //!< Iterator pointer
+				typedef my_const_iterator iterator; 
+
+			public:
+				//=== Alias
+				typedef std::bidirectional_iterator_tag iterator_category; //!< Nodes are linked both ways.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef const T * pointer; //!< Pointer to an element.
+				typedef const T & reference; //!< Reference to an element.
+				
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				constexpr my_const_iterator()
+					: it{nullptr}
+				{/*empty*/}
+
+				constexpr explicit my_const_iterator(Node * it)
+					: it{it}
+				{/*empty*/}
+
+				constexpr my_const_iterator( my_iterator other )
+					: it{ other.getIt() }
+				{/*empty*/}
+
+			public:
+				//=== Operators
+				constexpr iterator & operator++(void)
+				{ 
+					it = it->next;
+					return *this; 
 				}
 
-				friend iterator operator-(iterator it, int n)
-				{
-					for( int i = 0 ; i < n ; i++ )
-						it = it->prev;
-					return iterator( it );
+				constexpr iterator operator++(int)
+				{ 
+					iterator temp( it );
+					it = it->next;
+					return temp;
 				}
 
-				friend size_type operator-(iterator it1, iterator it2)
-				{
-					size_t count = 0;
-					while( it2 != it1 )
-					{
-						count++;
-						it2++;
-					}
-					return count;
+				constexpr reference operator*() const
+				{ return it->value(); }
+
+				constexpr pointer operator->() const
+				{ return &it->value(); }
+
+				constexpr iterator & operator--(void)
+				{ 
+					it = it->prev;
+					return *this; 
 				}
 
-				Node * operator->()
+				constexpr iterator operator--(int)
 				{
-					return it;
+					iterator temp( it );
+					it = it->prev;
+					return temp;
 				}
 
-				bool operator==( const iterator& it2) const
+				friend constexpr iterator operator+(offset_type n, iterator it)
+				{ return it.moved( n, true ); }
+
+				friend constexpr iterator operator+(iterator it, offset_type n)
+				{ return it.moved( n, true ); }
+
+				friend constexpr iterator operator-(offset_type n, iterator it)
+				{ return it.moved( n, false ); }
+
+				friend constexpr iterator operator-(iterator it, offset_type n)
+				{ return it.moved( n, false ); }
+
+				/// Returns the signed number of steps from it2 to it1.
+				friend constexpr difference_type operator-(iterator it1, iterator it2)
+				{ return it1.steps_from( it2 ); }
+
+				constexpr bool operator==( const iterator& it2) const
 				{ return it == it2.it; }
 
-				bool operator!=( const iterator& it2) const
+				constexpr bool operator!=( const iterator& it2) const
 				{ return it != it2.it; }
 
-				Node * getIt()
+				constexpr Node * getIt() const
 				{ return it; }
+
+			private:
+				/// Returns the iterator n nodes away, towards the end when forward is set.
+				constexpr iterator moved( offset_type n, bool forward ) const
+				{ return iterator( step( it, n, forward ) ); }
+
+				/// Returns the signed number of steps from it2 to this iterator.
+				constexpr difference_type steps_from( const iterator & it2 ) const
+				{ return distance( it2.it, it ); }
 		}; // class my_const_iterator
 		
 	}; // class list
 
+	/// Erases all the elements of c for which pred returns true. Returns the number of erased elements.
+	template< typename T, typename Allocator, typename Layout, typename Pred >
+	size_t erase_if( list< T, Allocator, Layout > & c, Pred pred )
+	{
+		return c.remove_if( pred );
+	}
+
 } // namespace sc
 
 #endif
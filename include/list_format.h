@@ -0,0 +1,194 @@
+#ifndef LIST_FORMAT_H
+#define LIST_FORMAT_H
+
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include "list.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/// Characters that std::to_chars may need for one value of T, in its shortest form.
+	template< typename T >
+	constexpr size_t max_chars( )
+	{
+		static_assert( std::is_arithmetic< T >::value and not std::is_same< T, bool >::value,
+			"sc::format_to() and sc::parse() handle the arithmetic types but bool" );
+
+		if( std::is_floating_point< T >::value )
+			return std::numeric_limits< T >::max_digits10 + 8; // sign, point, exponent
+		return std::numeric_limits< T >::digits10 + 3; // sign, the last partial digit
+	}
+
+	/// Writes seq to [first; last) in the bracket format of operator<<, "[ a b c ]", with std::to_chars:
+	/// floating-point values take their shortest round-trip form, not the stream's precision. Returns the end
+	/// of the text, or last and std::errc::value_too_large when it doesn't fit.
+	template< typename T, typename Allocator, typename Layout >
+	std::to_chars_result format_to( char * first, char * last, const list< T, Allocator, Layout > & seq )
+	{
+		if( last - first < 2 )
+			return { last, std::errc::value_too_large };
+		*first++ = '[';
+		*first++ = ' ';
+
+		for( auto it = seq.begin() ; it != seq.end() ; ++it )
+		{
+			std::to_chars_result written = std::to_chars( first, last, *it );
+			if( written.ec != std::errc() or written.ptr == last )
+				return { last, std::errc::value_too_large };
+			first = written.ptr;
+			*first++ = ' ';
+		}
+
+		if( first == last )
+			return { last, std::errc::value_too_large };
+		*first++ = ']';
+
+		return { first, std::errc() };
+	}
+
+	/// Appends seq to buffer in the bracket format, as the overload above. The text is written in chunks on the
+	/// stack and appended, buffer only grows when its capacity is short: reusing it across calls saves the allocations.
+	template< typename T, typename Allocator, typename Layout >
+	void format_to( std::string & buffer, const list< T, Allocator, Layout > & seq )
+	{
+		constexpr size_t width = max_chars< T >() + 1; // A value and its space.
+		size_t worst = 3 + seq.size() * width;
+		if( buffer.capacity() - buffer.size() < worst )
+			buffer.reserve( buffer.size() + worst );
+
+		char chunk[4096];
+		char * const chunk_end = chunk + sizeof( chunk );
+		char * fast = chunk;
+		*fast++ = '[';
+		*fast++ = ' ';
+
+		for( auto it = seq.begin() ; it != seq.end() ; ++it )
+		{
+			if( static_cast< size_t >( chunk_end - fast ) < width )
+			{
+				buffer.append( chunk, fast );
+				fast = chunk;
+			}
+			fast = std::to_chars( fast, chunk_end, *it ).ptr;
+			*fast++ = ' ';
+		}
+
+		if( fast == chunk_end )
+		{
+			buffer.append( chunk, fast );
+			fast = chunk;
+		}
+		*fast++ = ']';
+		buffer.append( chunk, fast );
+	}
+
+	/// Reads a list in the format of format_to() and operator<< from the start of text and appends its
+	/// elements to seq as they are read, with std::from_chars. Returns the number of characters read, up
+	/// to the ']'. On an error the elements read so far stay in seq, see parse() for the strong guarantee.
+	/// The nodes come from seq's spare capacity first, see list::reserve().
+	template< typename T, typename Allocator, typename Layout >
+	size_t parse_elements( std::string_view text, list< T, Allocator, Layout > & seq )
+	{
+		const char * first = text.data();
+		const char * last = text.data() + text.size();
+		auto skip_spaces = [&first, last]( ){
+			while( first != last and ( *first == ' ' or *first == '\t' or *first == '\n' or *first == '\r' ) )
+				first++;
+		};
+
+		skip_spaces();
+		if( first == last or *first != '[' )
+			throw std::invalid_argument("error in parse(): expected '['");
+		first++;
+
+		while( true )
+		{
+			skip_spaces();
+			if( first == last )
+				throw std::invalid_argument("error in parse(): expected ']'");
+			if( *first == ']' )
+				break;
+
+			T value;
+			std::from_chars_result read = std::from_chars( first, last, value );
+			if( read.ec != std::errc() )
+				throw std::invalid_argument("error in parse(): invalid element");
+			first = read.ptr;
+			if( first != last and *first != ' ' and *first != '\t' and *first != '\n' and *first != '\r' and *first != ']' )
+				throw std::invalid_argument("error in parse(): invalid element");
+
+			seq.push_back( value );
+		}
+
+		return first + 1 - text.data();
+	}
+
+	/// Reads a list in the format of format_to() and operator<< from the start of text and appends its
+	/// elements to seq. Returns the number of characters read, up to the ']'. On an error seq is left
+	/// unchanged: the elements are read into a list of their own, spliced at the end of seq once all are read.
+	template< typename T, typename Allocator, typename Layout >
+	size_t parse( std::string_view text, list< T, Allocator, Layout > & seq )
+	{
+		list< T, Allocator, Layout > parsed( seq.get_allocator() );
+		size_t used = parse_elements( text, parsed );
+		seq.splice( seq.end(), parsed );
+
+		return used;
+	}
+
+	/// Returns the list written in text by format_to() or operator<<. Only whitespace may follow it.
+	template< typename T >
+	list< T > parse( std::string_view text )
+	{
+		list< T > seq;
+		size_t used = parse( text, seq );
+
+		for( char c : text.substr( used ) )
+		{
+			if( c != ' ' and c != '\t' and c != '\n' and c != '\r' )
+				throw std::invalid_argument("error in parse(): unexpected text after ']'");
+		}
+
+		return seq;
+	}
+
+	/// Replaces the contents of seq with the list read from is, as written by operator<<.
+	/// Sets failbit and leaves seq empty when the text is not a list.
+	template< typename T, typename Allocator, typename Layout >
+	std::istream & operator>>( std::istream & is, list< T, Allocator, Layout > & seq )
+	{
+		// Erased nodes stay as spare capacity, reading into the same list again doesn't allocate.
+		seq.erase( seq.begin(), seq.end() );
+
+		std::string text;
+		if( not std::getline( is, text, ']' ) or is.eof() )
+		{
+			// Nothing left to read, or the text ended before the ']'.
+			is.setstate( std::ios_base::failbit );
+			return is;
+		}
+		text += ']';
+
+		try {
+			parse_elements( text, seq );
+		} catch( std::invalid_argument & ) {
+			seq.erase( seq.begin(), seq.end() );
+			is.setstate( std::ios_base::failbit );
+		}
+
+		return is;
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef LIST_NODE_H
+#define LIST_NODE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	//=== Node layout policies of sc::list
+	/// The element first, then the links. The default, nodes are as small as they get.
+	struct data_first{};
+
+	/// The links first, so that they sit at the start of the node whatever the size of the element.
+	struct links_first{};
+
+	/// Links first and every node starting on its own cache line: a walk touches one line per node.
+	struct cache_aligned{
+		static constexpr size_t line_size=64; //!< Bytes per cache line.
+	};
+
+	/// The links and a pointer to the element, kept in a payload_arena. Walks over large elements stay dense in cache.
+	struct out_of_line{};
+
+	/// Stands for the order-maintenance label when SC_LIST_ORDER_LABELS is not defined.
+	struct no_label{};
+
+
+	/*! \struct list_node
+		\brief node of sc::list, laid out as Layout says.
+
+		Every layout has next, prev, label, value() and storage(). The constructors
+		leave the links null and the element unconstructed: sc::list builds it in
+		storage() when the node takes an element and destroys it when the node is
+		unlinked, so spare nodes and sentinels hold no live T.
+	*/
+	template< typename T, typename Layout, typename Label >
+	struct list_node;
+
+	template< typename T, typename Label >
+	struct list_node< T, data_first, Label >{
+		union{ T data; }; //!< The element, alive only while the node is linked.
+		list_node* next;
+		list_node* prev;
+		[[no_unique_address]] Label label; //!< Order-maintenance label, increasing from head to tail.
+
+		constexpr list_node( )
+			: next{nullptr}, prev{nullptr}, label{}
+		{/*empty*/}
+
+		constexpr ~list_node( )
+		{/*empty*/}
+
+		constexpr T & value( )
+		{ return data; }
+
+		constexpr T * storage( )
+		{ return std::addressof( data ); }
+	};
+
+	template< typename T, typename Label >
+	struct list_node< T, links_first, Label >{
+		list_node* next;
+		list_node* prev;
+		[[no_unique_address]] Label label; //!< Order-maintenance label, increasing from head to tail.
+		union{ T data; }; //!< The element, alive only while the node is linked.
+
+		constexpr list_node( )
+			: next{nullptr}, prev{nullptr}, label{}
+		{/*empty*/}
+
+		constexpr ~list_node( )
+		{/*empty*/}
+
+		constexpr T & value( )
+		{ return data; }
+
+		constexpr T * storage( )
+		{ return std::addressof( data ); }
+	};
+
+	template< typename T, typename Label >
+	struct alignas( cache_aligned::line_size ) list_node< T, cache_aligned, Label >{
+		list_node* next;
+		list_node* prev;
+		[[no_unique_address]] Label label; //!< Order-maintenance label, increasing from head to tail.
+		union{ T data; }; //!< The element, alive only while the node is linked.
+
+		constexpr list_node( )
+			: next{nullptr}, prev{nullptr}, label{}
+		{/*empty*/}
+
+		constexpr ~list_node( )
+		{/*empty*/}
+
+		constexpr T & value( )
+		{ return data; }
+
+		constexpr T * storage( )
+		{ return std::addressof( data ); }
+	};
+
+	template< typename T, typename Label >
+	struct list_node< T, out_of_line, Label >{
+		list_node* next;
+		list_node* prev;
+		[[no_unique_address]] Label label; //!< Order-maintenance label, increasing from head to tail.
+		T * payload; //!< Slot of the element, kept while the node is spare; nullptr in the sentinels.
+
+		constexpr list_node( )
+			: next{nullptr}, prev{nullptr}, label{}, payload{nullptr}
+		{/*empty*/}
+
+		constexpr T & value( )
+		{ return *payload; }
+
+		constexpr T * storage( )
+		{ return payload; }
+	};
+
+
+	/*! \class payload_arena
+		\brief slots for the elements of out_of_line nodes, cut from large chunks.
+
+		Elements allocated one by one would sit between the nodes in the heap and
+		spread them out; cut from chunks they leave the nodes packed together. The
+		arena is shared by every list of T with the same allocator, so nodes can be
+		spliced between lists and freed by the node_reclaimer.
+
+		Each thread takes and gives slots through its own cache and only locks the
+		arena to move batch slots at once, so lists on different threads don't
+		serialize on it. The arena is never destroyed: nodes freed late in the exit
+		(node_reclaimer, static lists, thread caches) still have somewhere to go.
+		Its chunks are released by the operating system with the process.
+	*/
+	template< typename T, typename Allocator >
+	class payload_arena{
+		private:
+			//=== Alias
+			typedef std::allocator_traits< Allocator > alloc_traits; //!< Interface of the allocator.
+			static constexpr size_t chunk_slots=std::max< size_t >( ( size_t{1} << 16 ) / sizeof( T ), 1 ); //!< Slots per chunk, about 64 KiB.
+			static constexpr size_t batch=64; //!< Slots moved at once between a thread cache and the arena.
+
+			/// Slots of one thread, handed back to the arena when the thread exits.
+			struct thread_cache{
+				std::vector< T * > slots; //!< Free slots, taken from the back.
+				bool * gone; //!< Set once the cache is destroyed.
+
+				~thread_cache( )
+				{
+					*gone = true;
+					instance().put_back( slots, slots.size() );
+				}
+			};
+
+			//=== Attributes
+			std::mutex m_mutex; //!< Guards everything below.
+			Allocator m_alloc; //!< Source of the chunks.
+			std::vector< T * > m_chunks; //!< Every chunk, kept reachable for leak checkers.
+			std::vector< T * > m_free; //!< Slots given back by the threads.
+			T * m_next = nullptr; //!< Next slot never used of the last chunk.
+			T * m_end = nullptr; //!< End of the last chunk.
+
+			payload_arena( ) = default;
+
+			/// Returns the cache of the calling thread, nullptr once the thread is exiting and the cache is destroyed.
+			static std::vector< T * > * local( )
+			{
+				thread_local bool gone = false;
+				if( gone )
+					return nullptr;
+				thread_local thread_cache cache{ {}, &gone };
+				return &cache.slots;
+			}
+
+			/// Moves batch slots to cache, given back ones first.
+			void refill( std::vector< T * > & cache )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				while( cache.size() < batch and not m_free.empty() )
+				{
+					cache.push_back( m_free.back() );
+					m_free.pop_back();
+				}
+
+				// Backwards, so that the cache hands out consecutive slots in address order.
+				size_t missing = batch - cache.size();
+				size_t first = cache.size();
+				for( size_t i = 0 ; i < missing ; i++ )
+				{
+					if( m_next == m_end )
+					{
+						m_next = alloc_traits::allocate( m_alloc, chunk_slots );
+						m_end = m_next + chunk_slots;
+						m_chunks.push_back( m_next );
+					}
+					cache.push_back( m_next++ );
+				}
+				std::reverse( cache.begin() + first, cache.end() );
+			}
+
+			/// Moves the last count slots of cache back to the arena.
+			void put_back( std::vector< T * > & cache, size_t count )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_free.insert( m_free.end(), cache.end() - count, cache.end() );
+				cache.resize( cache.size() - count );
+			}
+
+		public:
+			/// Returns the arena of T, created on first use and never destroyed.
+			static payload_arena & instance( )
+			{
+				static payload_arena * arena = new payload_arena;
+				return *arena;
+			}
+
+			payload_arena( const payload_arena& ) = delete;
+			payload_arena& operator=( const payload_arena& ) = delete;
+
+			/// Returns room for one T, nothing is constructed in it.
+			T * take( )
+			{
+				std::vector< T * > * cache = local();
+				std::vector< T * > one;
+				if( cache == nullptr )
+					cache = &one;
+				if( cache->empty() )
+					refill( *cache );
+
+				T * slot = cache->back();
+				cache->pop_back();
+				if( cache == &one )
+					put_back( one, one.size() );
+				return slot;
+			}
+
+			/// Takes back a slot from take(), whose element was destroyed. Any thread may give it.
+			void give( T * slot )
+			{
+				std::vector< T * > * cache = local();
+				if( cache == nullptr )
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					m_free.push_back( slot );
+					return;
+				}
+
+				cache->push_back( slot );
+				if( cache->size() >= 2 * batch )
+					put_back( *cache, batch );
+			}
+	}; // class payload_arena
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,547 @@
+#ifndef LIST_POOL_H
+#define LIST_POOL_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class list_pool
+    	\brief many small singly linked lists sharing one node arena, named by 32-bit handles.
+
+    	An sc::list costs its object, two sentinels and one allocation per node, which
+    	dwarfs short lists of small elements. Here a list is 12 bytes in the pool (first,
+    	last, size) and a node is the element plus a 32-bit next index, cut from chunks
+    	of about 64 KiB. Freed nodes and handles are reused, so building and dropping
+    	millions of adjacency or bucket lists is mostly allocation-free.
+
+    	    sc::list_pool<int> pool;
+    	    auto h = pool.create();
+    	    pool.push_back( h, 4 );
+    	    for( int x : pool.range( h ) ) ...
+
+    	References and iterators stay valid while the pool grows, as the chunks never
+    	move. Using a handle after destroy() or clear() is undefined. The pool can be
+    	moved but not copied.
+	*/
+	template< typename T, typename Allocator = std::allocator< T > >
+	class list_pool{
+		public:
+			//=== Alias
+			typedef uint32_t handle; //!< Names a list of the pool.
+			typedef uint32_t size_type; //!< Type of the sizes, a pool holds less than 2^32 nodes.
+
+		private:
+			typedef uint32_t index; //!< Position of a node in the arena.
+			static constexpr index nil=std::numeric_limits< index >::max(); //!< No node.
+
+			//=== Attributes
+			struct Node{
+				alignas( T ) unsigned char storage[sizeof( T )]; //!< The element, constructed only while the node is in a list.
+				index next; //!< Next node of the list, or of the free list.
+
+				T & value( )
+				{ return *std::launder( reinterpret_cast< T * >( storage ) ); }
+
+				const T & value( ) const
+				{ return *std::launder( reinterpret_cast< const T * >( storage ) ); }
+			};
+
+			struct header{
+				index first; //!< First node, nil when empty.
+				index last; //!< Last node, meaningless when empty.
+				size_type size; //!< Number of elements.
+			};
+
+			typedef typename std::allocator_traits< Allocator >::template rebind_alloc< Node > node_allocator; //!< Allocates the chunks.
+			typedef std::allocator_traits< node_allocator > node_traits; //!< Interface of node_allocator.
+			static constexpr unsigned chunk_bits=sizeof( Node ) >= ( size_t{1} << 16 ) ? 0 : 16 - std::bit_width( sizeof( Node ) - 1 ); //!< log2 of the nodes per chunk.
+			static constexpr index chunk_nodes=index{1} << chunk_bits; //!< Nodes per chunk, about 64 KiB.
+
+			[[no_unique_address]] node_allocator m_alloc; //!< Source of the chunks.
+			std::vector< Node * > m_chunks; //!< Every chunk, node i is in m_chunks[i >> chunk_bits].
+			std::vector< header > m_lists; //!< Every list, indexed by handle.
+			std::vector< handle > m_free_lists; //!< Handles given back by destroy().
+			index m_free; //!< Nodes given back, linked through next.
+			index m_next; //!< First node never used, the arena is full when it reaches capacity().
+			size_type m_size; //!< Number of elements in all the lists.
+
+		public:
+			template< bool Const >
+			class my_basic_iterator;
+
+			typedef my_basic_iterator< false > my_iterator; //!< Forward iterator.
+			typedef my_basic_iterator< true > my_const_iterator; //!< Read-only forward iterator.
+
+			/*! \struct my_range
+				\brief the elements of one list, for range-for and the algorithms.
+			*/
+			template< typename Iterator >
+			struct my_range{
+				Iterator first; //!< The first element.
+				Iterator last; //!< The end mark.
+
+				Iterator begin( ) const
+				{ return first; }
+
+				Iterator end( ) const
+				{ return last; }
+			};
+
+			//=== Standard container alias
+			typedef T value_type; //!< Type of the elements.
+			typedef T & reference; //!< Reference to an element.
+			typedef const T & const_reference; //!< Read-only reference to an element.
+			typedef my_iterator iterator; //!< Forward iterator.
+			typedef my_const_iterator const_iterator; //!< Read-only forward iterator.
+			typedef Allocator allocator_type; //!< Allocator the chunks are obtained from, rebound to the nodes.
+
+			//=== Constructors
+			/// Default constructor, with no list and no node.
+			list_pool( )
+				: m_free{nil}, m_next{0}, m_size{0}
+			{/*empty*/}
+
+			/// Empty pool allocating its chunks from alloc.
+			explicit list_pool( const Allocator & alloc )
+				: m_alloc( alloc ), m_free{nil}, m_next{0}, m_size{0}
+			{/*empty*/}
+
+			list_pool( const list_pool& ) = delete;
+			list_pool& operator=( const list_pool& ) = delete;
+
+			/// Takes over the lists, nodes and handles of other, which is left empty.
+			list_pool( list_pool&& other ) noexcept
+				: m_alloc( std::move( other.m_alloc ) ), m_chunks( std::move( other.m_chunks ) ), m_lists( std::move( other.m_lists ) ),
+				  m_free_lists( std::move( other.m_free_lists ) ), m_free{other.m_free}, m_next{other.m_next}, m_size{other.m_size}
+			{
+				other.forget();
+			}
+
+			/// Destroys the elements, frees the chunks and takes over other's. The allocators must compare equal.
+			list_pool& operator=( list_pool&& other ) noexcept
+			{
+				if( this != &other )
+				{
+					release();
+					m_chunks = std::move( other.m_chunks );
+					m_lists = std::move( other.m_lists );
+					m_free_lists = std::move( other.m_free_lists );
+					m_free = other.m_free;
+					m_next = other.m_next;
+					m_size = other.m_size;
+					other.forget();
+				}
+
+				return *this;
+			}
+
+			/// Destructor.
+			~list_pool( )
+			{
+				release();
+			}
+
+			//=== Lists
+			/// Returns the handle of a new empty list, reusing a destroyed one's.
+			handle create( )
+			{
+				if( not m_free_lists.empty() )
+				{
+					handle h = m_free_lists.back();
+					m_free_lists.pop_back();
+					return h;
+				}
+
+				if( m_lists.size() >= nil )
+					throw std::length_error("error in create(): more than 2^32 - 1 lists");
+				m_lists.push_back( header{ nil, nil, 0 } );
+				return static_cast< handle >( m_lists.size() - 1 );
+			}
+
+			/// Clears the list h and gives its handle back for create() to reuse.
+			void destroy( handle h )
+			{
+				clear( h );
+				m_free_lists.push_back( h );
+			}
+
+			/// Destroys every element and every list at once. The chunks are kept for the next lists.
+			void clear( )
+			{
+				destroy_all( std::is_trivially_destructible< T >() );
+				m_lists.clear();
+				m_free_lists.clear();
+				m_free = nil;
+				m_next = 0;
+				m_size = 0;
+			}
+
+			/// Returns the number of live lists.
+			size_t list_count( ) const
+			{ return m_lists.size() - m_free_lists.size(); }
+
+			/// Returns the number of elements in all the lists.
+			size_type node_count( ) const
+			{ return m_size; }
+
+			/// Returns the number of elements the pool can hold before allocating a new chunk.
+			size_t capacity( ) const
+			{ return m_chunks.size() * chunk_nodes; }
+
+			/// Allocates chunks until the pool can hold nodes elements.
+			void reserve( size_t nodes )
+			{
+				while( capacity() < nodes and capacity() < nil )
+					add_chunk();
+			}
+
+			/// Makes room for lists handles without reallocating the list table.
+			void reserve_lists( size_t lists )
+			{ m_lists.reserve( lists ); }
+
+			/// Returns the bytes held by the pool: chunks, list table and free handles.
+			size_t memory_bytes( ) const
+			{
+				return capacity() * sizeof( Node ) + m_chunks.capacity() * sizeof( Node * )
+					+ m_lists.capacity() * sizeof( header ) + m_free_lists.capacity() * sizeof( handle );
+			}
+
+			/// Returns a copy of the allocator.
+			allocator_type get_allocator( ) const
+			{ return allocator_type( m_alloc ); }
+
+			//=== Methods on one list
+			/// Returns the size of the list h.
+			size_type size( handle h ) const
+			{ return m_lists[h].size; }
+
+			/// Checks if the list h is empty.
+			bool empty( handle h ) const
+			{ return m_lists[h].size == 0; }
+
+			/// Returns the first element of the list h, which must not be empty.
+			T & front( handle h )
+			{ return node( m_lists[h].first ).value(); }
+
+			const T & front( handle h ) const
+			{ return node( m_lists[h].first ).value(); }
+
+			/// Returns the last element of the list h, which must not be empty.
+			T & back( handle h )
+			{ return node( m_lists[h].last ).value(); }
+
+			const T & back( handle h ) const
+			{ return node( m_lists[h].last ).value(); }
+
+			/// Returns an iterator pointing to the first element of the list h.
+			my_iterator begin( handle h )
+			{ return my_iterator( this, m_lists[h].first ); }
+
+			/// Returns an iterator pointing to the end mark of every list.
+			my_iterator end( handle )
+			{ return my_iterator( this, nil ); }
+
+			my_const_iterator begin( handle h ) const
+			{ return my_const_iterator( this, m_lists[h].first ); }
+
+			my_const_iterator end( handle ) const
+			{ return my_const_iterator( this, nil ); }
+
+			/// Returns the elements of the list h, for range-for.
+			my_range< my_iterator > range( handle h )
+			{ return { begin( h ), end( h ) }; }
+
+			my_range< my_const_iterator > range( handle h ) const
+			{ return { begin( h ), end( h ) }; }
+
+			/// Adds value to the end of the list h.
+			void push_back( handle h, const T & value )
+			{ emplace_back( h, value ); }
+
+			void push_back( handle h, T && value )
+			{ emplace_back( h, std::move( value ) ); }
+
+			/// Adds an element built from args to the end of the list h. Returns it.
+			template< typename... Args >
+			T & emplace_back( handle h, Args &&... args )
+			{
+				index i = create_node( std::forward< Args >( args )... );
+				header & list = m_lists[h];
+				if( list.size == 0 )
+					list.first = i;
+				else
+					node( list.last ).next = i;
+				list.last = i;
+				list.size++;
+
+				return node( i ).value();
+			}
+
+			/// Adds value to the front of the list h.
+			void push_front( handle h, const T & value )
+			{
+				index i = create_node( value );
+				header & list = m_lists[h];
+				node( i ).next = list.first;
+				list.first = i;
+				if( list.size == 0 )
+					list.last = i;
+				list.size++;
+			}
+
+			/// Removes the first element of the list h, if any.
+			void pop_front( handle h )
+			{
+				header & list = m_lists[h];
+				if( list.size == 0 )
+					return;
+
+				index i = list.first;
+				list.first = node( i ).next;
+				list.size--;
+				if( list.size == 0 )
+					list.first = nil;
+
+				node( i ).value().~T();
+				recycle_node( i );
+			}
+
+			/// Removes every element of the list h, its nodes go back to the pool. O(1) when T is trivially destructible.
+			void clear( handle h )
+			{
+				header & list = m_lists[h];
+				if( list.size == 0 )
+					return;
+
+				destroy_elements( list.first, std::is_trivially_destructible< T >() );
+				node( list.last ).next = m_free;
+				m_free = list.first;
+				m_size -= list.size;
+
+				list = header{ nil, nil, 0 };
+			}
+
+			/// Moves every element of from to the end of to, in O(1). from is left empty.
+			void splice( handle to, handle from )
+			{
+				if( to == from or m_lists[from].size == 0 )
+					return;
+
+				header & source = m_lists[from];
+				header & target = m_lists[to];
+				if( target.size == 0 )
+					target.first = source.first;
+				else
+					node( target.last ).next = source.first;
+				target.last = source.last;
+				target.size += source.size;
+
+				source = header{ nil, nil, 0 };
+			}
+
+			/// Moves the first element of from to the end of to, relinking its node. Does nothing if from is empty.
+			void splice_front( handle to, handle from )
+			{
+				header & source = m_lists[from];
+				if( source.size == 0 or ( to == from and source.size == 1 ) )
+					return;
+
+				index i = source.first;
+				source.first = node( i ).next;
+				source.size--;
+				if( source.size == 0 )
+					source.first = nil;
+
+				header & target = m_lists[to];
+				node( i ).next = nil;
+				if( target.size == 0 )
+					target.first = i;
+				else
+					node( target.last ).next = i;
+				target.last = i;
+				target.size++;
+			}
+
+		private:
+			/// Returns node i.
+			Node & node( index i )
+			{ return m_chunks[i >> chunk_bits][i & ( chunk_nodes - 1 )]; }
+
+			const Node & node( index i ) const
+			{ return m_chunks[i >> chunk_bits][i & ( chunk_nodes - 1 )]; }
+
+			/// Allocates one more chunk. The table grows geometrically first, so the push_back can't throw.
+			void add_chunk( )
+			{
+				if( m_chunks.size() == m_chunks.capacity() )
+					m_chunks.reserve( std::max< size_t >( 2 * m_chunks.size(), 1 ) );
+				m_chunks.push_back( node_traits::allocate( m_alloc, chunk_nodes ) );
+			}
+
+			/// Returns an unlinked node holding an element built from args, a freed one when there is one.
+			template< typename... Args >
+			index create_node( Args &&... args )
+			{
+				index i = m_free;
+				bool fresh = i == nil;
+				if( fresh )
+				{
+					if( m_next == nil )
+						throw std::length_error("error in push_back(): more than 2^32 - 1 nodes");
+					if( m_next == capacity() )
+						add_chunk();
+					i = m_next;
+				}
+
+				Node & target = node( i );
+				index next = fresh ? nil : target.next;
+				::new( static_cast< void * >( target.storage ) ) T( std::forward< Args >( args )... );
+
+				// Only taken once the element is built, a throwing constructor leaves the pool as it was.
+				if( fresh )
+					m_next++;
+				else
+					m_free = next;
+				target.next = nil;
+				m_size++;
+
+				return i;
+			}
+
+			/// Gives back node i, whose element was destroyed.
+			void recycle_node( index i )
+			{
+				node( i ).next = m_free;
+				m_free = i;
+				m_size--;
+			}
+
+			/// Destroys the elements from node i to the end of its list.
+			void destroy_elements( index, std::true_type )
+			{/*empty*/}
+
+			void destroy_elements( index i, std::false_type )
+			{
+				for( ; i != nil ; i = node( i ).next )
+					node( i ).value().~T();
+			}
+
+			/// Destroys the elements of every list.
+			void destroy_all( std::true_type )
+			{/*empty*/}
+
+			void destroy_all( std::false_type )
+			{
+				for( const header & list : m_lists )
+				{
+					if( list.size != 0 )
+						destroy_elements( list.first, std::false_type() );
+				}
+			}
+
+			/// Destroys every element and frees the chunks.
+			void release( )
+			{
+				clear();
+				for( Node * chunk : m_chunks )
+					node_traits::deallocate( m_alloc, chunk, chunk_nodes );
+				m_chunks.clear();
+			}
+
+			/// Leaves the pool empty without touching what it held, after a move.
+			void forget( )
+			{
+				m_chunks.clear();
+				m_lists.clear();
+				m_free_lists.clear();
+				m_free = nil;
+				m_next = 0;
+				m_size = 0;
+			}
+
+		public:
+		/*! \class my_basic_iterator
+
+			Forward iterator over the elements of one list, read-only when Const is set.
+		*/
+		template< bool Const >
+		class my_basic_iterator{
+			private:
+				typedef typename std::conditional< Const, const list_pool *, list_pool * >::type pool_pointer;
+				typedef my_basic_iterator iterator;
+
+				pool_pointer m_pool; //!< Pool of the list.
+				index m_node; //!< Current node, nil at the end.
+
+				friend class my_basic_iterator< not Const >;
+
+			public:
+				//=== Alias
+				typedef std::forward_iterator_tag iterator_category; //!< Nodes are linked one way.
+				typedef T value_type; //!< Type of the elements.
+				typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+				typedef typename std::conditional< Const, const T *, T * >::type pointer; //!< Pointer to an element.
+				typedef typename std::conditional< Const, const T &, T & >::type reference; //!< Reference to an element.
+
+				//=== Constructor
+				/// Singular iterator, only good to be assigned to.
+				my_basic_iterator()
+					: m_pool{nullptr}, m_node{nil}
+				{/*empty*/}
+
+				my_basic_iterator( pool_pointer pool, index node )
+					: m_pool{pool}, m_node{node}
+				{/*empty*/}
+
+				/// A my_iterator converts to a my_const_iterator.
+				template< bool Other, typename = typename std::enable_if< Const and not Other >::type >
+				my_basic_iterator( const my_basic_iterator< Other > & other )
+					: m_pool{other.m_pool}, m_node{other.m_node}
+				{/*empty*/}
+
+				//=== Operators
+				iterator & operator++(void)
+				{
+					m_node = m_pool->node( m_node ).next;
+					return *this;
+				}
+
+				iterator operator++(int)
+				{
+					iterator temp( *this );
+					++*this;
+					return temp;
+				}
+
+				reference operator*() const
+				{ return m_pool->node( m_node ).value(); }
+
+				pointer operator->() const
+				{ return &**this; }
+
+				bool operator==( const iterator& it2) const
+				{ return m_node == it2.m_node; }
+
+				bool operator!=( const iterator& it2) const
+				{ return m_node != it2.m_node; }
+		}; // class my_basic_iterator
+
+	}; // class list_pool
+
+} // namespace sc
+
+#endif
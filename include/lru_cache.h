@@ -0,0 +1,204 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <functional>
+#include <limits>
+#include "hashed_list.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \struct lru_stats
+		\brief counters kept by an lru_cache.
+	*/
+	struct lru_stats{
+		size_t hits; //!< Lookups that found their key.
+		size_t misses; //!< Lookups that did not find their key.
+		size_t insertions; //!< Keys added to the cache.
+		size_t evictions; //!< Keys dropped to respect the capacity or the byte budget.
+	};
+
+	/// Default charge of an entry against the byte budget of an lru_cache.
+	template< typename K, typename V >
+	struct entry_bytes{
+		size_t operator()( const K &, const V & ) const
+		{ return sizeof( K ) + sizeof( V ); }
+	};
+
+
+	/*! \class lru_cache
+    	\brief least recently used cache built on sc::hashed_list.
+
+    	Entries live in an sc::hashed_list ordered from the least to the most recently
+    	used, whose table indexes them by key, so each key is stored once. A hit relinks
+    	its node at the back, and the nodes of evicted entries are reused by the next
+    	insertions through the spare nodes: once the cache is full, lookups, insertions
+    	and evictions don't allocate. Entries are evicted when there are more than
+    	capacity of them or when their total Sizer charge exceeds the byte budget.
+	*/
+	template< typename K, typename V, typename Sizer = entry_bytes< K, V >, typename Hash = std::hash< K > >
+	class lru_cache{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef std::function< void( const K &, V & ) > evict_callback; //!< Called with every evicted entry.
+
+			//=== Attributes
+			struct Entry{
+				K key;
+				V value;
+				size_type bytes; //!< Charge against the byte budget.
+			};
+
+			/// Key extractor of the entries.
+			struct entry_key{
+				const K & operator()( const Entry & entry ) const
+				{ return entry.key; }
+			};
+
+			typedef hashed_list< Entry, entry_key, Hash > entry_list;
+			typedef typename entry_list::my_iterator entry_iterator;
+
+			entry_list m_entries; //!< Least recently used entry at the front, indexed by key.
+			size_type m_capacity; //!< Maximum number of entries.
+			size_type m_byte_budget; //!< Maximum total charge of the entries.
+			size_type m_bytes; //!< Current total charge of the entries.
+			Sizer m_sizer; //!< Computes the charge of an entry.
+			evict_callback m_on_evict; //!< Eviction callback, may be empty.
+			lru_stats m_stats; //!< Hit/miss counters.
+
+		public:
+			//=== Constructors
+			/// Cache of at most capacity entries and byte_budget total charge.
+			explicit lru_cache( size_type capacity, size_type byte_budget = std::numeric_limits< size_type >::max() )
+				: m_capacity{capacity}, m_byte_budget{byte_budget}, m_bytes{0}, m_stats{ 0, 0, 0, 0 }
+			{/*empty*/}
+
+			// Entries hand out pointers to their values, so a cache can't be copied.
+			lru_cache( const lru_cache& ) = delete;
+			lru_cache& operator=( const lru_cache& ) = delete;
+
+			//=== Methods
+			/// Returns the number of entries.
+			size_type size( ) const
+			{ return m_entries.size(); }
+
+			/// Checks if the cache is empty.
+			bool empty( ) const
+			{ return m_entries.empty(); }
+
+			/// Returns the maximum number of entries.
+			size_type capacity( ) const
+			{ return m_capacity; }
+
+			/// Returns the total charge of the entries.
+			size_type bytes( ) const
+			{ return m_bytes; }
+
+			/// Returns the maximum total charge of the entries.
+			size_type byte_budget( ) const
+			{ return m_byte_budget; }
+
+			/// Returns the hit/miss counters.
+			const lru_stats & stats( ) const
+			{ return m_stats; }
+
+			/// Zeroes the hit/miss counters.
+			void reset_stats( )
+			{ m_stats = lru_stats{ 0, 0, 0, 0 }; }
+
+			/// Sets the function called with every entry evicted from now on.
+			void on_evict( evict_callback callback )
+			{ m_on_evict = callback; }
+
+			/// Checks if key is cached, without touching it or counting a hit.
+			bool contains( const K & key ) const
+			{ return m_entries.contains( key ); }
+
+			/// Returns the value of key and marks it as the most recently used, or nullptr on a miss.
+			V * get( const K & key )
+			{
+				entry_iterator found = m_entries.find( key );
+				if( found == m_entries.end() )
+				{
+					m_stats.misses++;
+					return nullptr;
+				}
+
+				m_stats.hits++;
+				m_entries.move_to_back( found );
+
+				return &found->value;
+			}
+
+			/// Caches value for key as the most recently used entry, evicting the least recently used
+			/// ones if needed. An entry charged more than the byte budget stays alone in the cache.
+			void put( const K & key, const V & value )
+			{
+				size_type bytes = m_sizer( key, value );
+
+				entry_iterator found = m_entries.find( key );
+				if( found != m_entries.end() )
+				{
+					Entry & entry = *found;
+					m_bytes = m_bytes - entry.bytes + bytes;
+					entry.value = value;
+					entry.bytes = bytes;
+					m_entries.move_to_back( found );
+				}
+				else
+				{
+					m_entries.push_back( Entry{ key, value, bytes } );
+					m_bytes += bytes;
+					m_stats.insertions++;
+				}
+
+				while( m_entries.size() > 1 and ( m_entries.size() > m_capacity or m_bytes > m_byte_budget ) )
+					evict();
+
+				// A zero capacity cache keeps nothing.
+				if( m_capacity == 0 and not m_entries.empty() )
+					evict();
+			}
+
+			/// Removes key without calling the eviction callback. Returns false if it was not cached.
+			bool erase( const K & key )
+			{
+				entry_iterator found = m_entries.find( key );
+				if( found == m_entries.end() )
+					return false;
+
+				m_bytes -= found->bytes;
+				m_entries.erase( found );
+
+				return true;
+			}
+
+			/// Removes all the entries without calling the eviction callback.
+			void clear( )
+			{
+				m_entries.clear();
+				m_bytes = 0;
+			}
+
+		private:
+			/// Drops the least recently used entry.
+			void evict( )
+			{
+				entry_iterator victim = m_entries.begin();
+				Entry & entry = *victim;
+
+				if( m_on_evict )
+					m_on_evict( entry.key, entry.value );
+
+				m_bytes -= entry.bytes;
+				m_entries.erase( victim );
+				m_stats.evictions++;
+			}
+	}; // class lru_cache
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef NODE_RECLAIMER_H
+#define NODE_RECLAIMER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class node_reclaimer
+		\brief background thread that frees node chains handed over by list::clear_async().
+
+		Posting a chain is O(1) for the caller, the nodes are released later on the reclaimer thread.
+		Once the reclaimer has shut down, e.g. while static objects are destroyed at exit, dispose()
+		releases the chains on the calling thread instead.
+	*/
+	class node_reclaimer{
+		public:
+			//=== Alias
+			typedef void (*release_fn)( void * ); //!< Frees a whole chain.
+
+		private:
+			//=== Attributes
+			struct Job{
+				void * chain;
+				release_fn release;
+			};
+
+			std::mutex m_mutex; //!< Guards the job queue.
+			std::condition_variable m_wake; //!< Signals new jobs, or that the queue got empty.
+			std::vector< Job > m_jobs; //!< Chains waiting to be released.
+			size_t m_running; //!< Number of jobs being released right now.
+			bool m_stop; //!< Set when the reclaimer is shutting down.
+			std::thread m_thread; //!< Thread releasing the chains.
+
+			node_reclaimer( )
+				: m_running{0}, m_stop{false}, m_thread{ &node_reclaimer::run, this }
+			{/*empty*/}
+
+			void run( )
+			{
+				std::unique_lock< std::mutex > lock( m_mutex );
+				while( true )
+				{
+					m_wake.wait( lock, [this]{ return m_stop or not m_jobs.empty(); } );
+					if( m_jobs.empty() )
+						return;
+
+					std::vector< Job > jobs;
+					jobs.swap( m_jobs );
+					m_running = jobs.size();
+
+					lock.unlock();
+					for( const Job & job : jobs )
+						job.release( job.chain );
+					lock.lock();
+
+					m_running = 0;
+					m_wake.notify_all();
+				}
+			}
+
+			/// Set once the process wide reclaimer is destroyed. Trivially destructible, so it outlives every static.
+			static std::atomic< bool > & destroyed( )
+			{
+				static std::atomic< bool > flag{ false };
+				return flag;
+			}
+
+		public:
+			node_reclaimer( const node_reclaimer& ) = delete;
+			node_reclaimer& operator=( const node_reclaimer& ) = delete;
+
+			/// Releases the pending chains and stops the thread.
+			~node_reclaimer( )
+			{
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					m_stop = true;
+				}
+				m_wake.notify_all();
+				m_thread.join();
+				destroyed().store( true, std::memory_order_release );
+			}
+
+			/// Returns the process wide reclaimer. Not to be called once it is destroyed, see dispose().
+			static node_reclaimer & instance( )
+			{
+				static node_reclaimer reclaimer;
+				return reclaimer;
+			}
+
+			/// Hands chain over to the process wide reclaimer, or calls release( chain ) right away when it is gone.
+			static void dispose( void * chain, release_fn release )
+			{
+				if( destroyed().load( std::memory_order_acquire ) )
+					release( chain );
+				else
+					instance().post( chain, release );
+			}
+
+			/// Hands chain over to the reclaimer thread, which will call release( chain ). Once the reclaimer
+			/// is shutting down, calls it on this thread instead.
+			void post( void * chain, release_fn release )
+			{
+				bool queued;
+				{
+					std::lock_guard< std::mutex > lock( m_mutex );
+					queued = not m_stop;
+					if( queued )
+						m_jobs.push_back( Job{ chain, release } );
+				}
+
+				if( queued )
+					m_wake.notify_all();
+				else
+					release( chain );
+			}
+
+			/// Blocks until every chain posted so far has been released.
+			void wait_idle( )
+			{
+				std::unique_lock< std::mutex > lock( m_mutex );
+				m_wake.wait( lock, [this]{ return m_jobs.empty() and m_running == 0; } );
+			}
+	}; // class node_reclaimer
+
+} // namespace sc
+
+#endif
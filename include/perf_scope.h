@@ -0,0 +1,188 @@
+#ifndef PERF_SCOPE_H
+#define PERF_SCOPE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \struct perf_counts
+		\brief hardware events counted by a perf_scope. A count is only meaningful if its counter opened.
+	*/
+	struct perf_counts{
+		/// The events, also the indices of the counters.
+		enum event{ instructions, cycles, llc_misses, dtlb_misses, branch_misses, event_count };
+
+		uint64_t value[event_count]; //!< Count of each event, scaled up when the counter was multiplexed.
+		bool valid[event_count]; //!< Whether each counter could be opened.
+
+		/// Returns true if at least one counter works.
+		bool any( ) const
+		{
+			for( bool v : valid )
+			{
+				if( v )
+					return true;
+			}
+			return false;
+		}
+
+		/// Returns the name of an event.
+		static const char * name( event e )
+		{
+			static const char * names[event_count] = { "instructions", "cycles", "LLC misses", "dTLB misses", "branch misses" };
+			return names[e];
+		}
+	};
+
+
+	/*! \class perf_scope
+    	\brief counts hardware events of the calling thread, and of the threads it starts meanwhile, from construction until destruction.
+
+    	Built on Linux perf_event_open(), user space only. Each event has its own
+    	counter, so the ones the CPU or the kernel settings (perf_event_paranoid,
+    	containers) refuse are just marked invalid and the others still count.
+    	When the PMU multiplexes the counters, counts are scaled to the whole scope.
+    	Threads started in the scope add their counts when they exit.
+
+    	    {
+    	        sc::perf_scope scope;
+    	        walk( seq );
+    	        scope.report( std::cout, "walk", seq.size() );
+    	    }
+	*/
+	class perf_scope{
+		private:
+			int m_fd[perf_counts::event_count]; //!< Counter of each event, -1 when it didn't open.
+			int m_error; //!< errno of the first counter that didn't open.
+
+		public:
+			//=== Constructors
+			/// Opens and starts the counters.
+			perf_scope( )
+				: m_error{0}
+			{
+				for( int e = 0 ; e < perf_counts::event_count ; e++ )
+				{
+					m_fd[e] = open_counter( static_cast< perf_counts::event >( e ) );
+					if( m_fd[e] < 0 and m_error == 0 )
+						m_error = errno;
+				}
+
+				for( int fd : m_fd )
+				{
+					if( fd >= 0 )
+						ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+				}
+			}
+
+			perf_scope( const perf_scope& ) = delete;
+			perf_scope& operator=( const perf_scope& ) = delete;
+
+			/// Stops and closes the counters.
+			~perf_scope( )
+			{
+				for( int fd : m_fd )
+				{
+					if( fd >= 0 )
+						close( fd );
+				}
+			}
+
+			//=== Methods
+			/// Returns the events counted so far.
+			perf_counts read( ) const
+			{
+				perf_counts counts{};
+				for( int e = 0 ; e < perf_counts::event_count ; e++ )
+				{
+					// Value, time enabled, time running.
+					uint64_t data[3];
+					if( m_fd[e] < 0 or ::read( m_fd[e], data, sizeof( data ) ) != sizeof( data ) )
+						continue;
+
+					counts.valid[e] = true;
+					counts.value[e] = data[2] == 0 or data[2] == data[1] ? data[0]
+						: static_cast< uint64_t >( static_cast< double >( data[0] ) * data[1] / data[2] );
+				}
+				return counts;
+			}
+
+			/// Returns why some counter didn't open, empty when they all did.
+			std::string error( ) const
+			{ return m_error == 0 ? std::string() : std::string( std::strerror( m_error ) ); }
+
+			/// Writes the events counted so far per element, for elements items processed in the scope.
+			void report( std::ostream & os, const char * name, size_t elements ) const
+			{ report( os, name, read(), elements ); }
+
+			/// Writes counts per element on one line, nothing if no counter worked.
+			static void report( std::ostream & os, const char * name, const perf_counts & counts, size_t elements )
+			{
+				if( not counts.any() )
+					return;
+
+				os << "    " << name << ":";
+				for( int e = 0 ; e < perf_counts::event_count ; e++ )
+				{
+					if( counts.valid[e] )
+						os << " " << static_cast< double >( counts.value[e] ) / ( elements == 0 ? 1 : elements ) << " " << perf_counts::name( static_cast< perf_counts::event >( e ) );
+				}
+				os << " per element\n";
+			}
+
+		private:
+			/// Opens a disabled counter of e for the calling thread and its new threads, on any CPU. Returns -1 and sets errno on failure.
+			static int open_counter( perf_counts::event e )
+			{
+				perf_event_attr attr;
+				std::memset( &attr, 0, sizeof( attr ) );
+				attr.size = sizeof( attr );
+				attr.disabled = 1;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.inherit = 1;
+				attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				switch( e )
+				{
+					case perf_counts::instructions:
+						attr.type = PERF_TYPE_HARDWARE;
+						attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+						break;
+					case perf_counts::cycles:
+						attr.type = PERF_TYPE_HARDWARE;
+						attr.config = PERF_COUNT_HW_CPU_CYCLES;
+						break;
+					case perf_counts::llc_misses:
+						attr.type = PERF_TYPE_HW_CACHE;
+						attr.config = PERF_COUNT_HW_CACHE_LL | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+						break;
+					case perf_counts::dtlb_misses:
+						attr.type = PERF_TYPE_HW_CACHE;
+						attr.config = PERF_COUNT_HW_CACHE_DTLB | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+						break;
+					default:
+						attr.type = PERF_TYPE_HARDWARE;
+						attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+						break;
+				}
+
+				return static_cast< int >( syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ) );
+			}
+	}; // class perf_scope
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,487 @@
+#ifndef SNAPSHOT_LIST_H
+#define SNAPSHOT_LIST_H
+
+#include <atomic>
+#include <stdexcept>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+
+	/*! \class snapshot_list
+    	\brief doubly linked list with wait-free read-only snapshots.
+
+    	A single writer thread mutates the list with push_back/push_front/insert/erase
+    	while any number of reader threads iterate consistent snapshots of it.
+    	Every node is stamped with the version that created it and the version that
+    	erased it, so a snapshot taken at version v only sees nodes alive at v.
+    	Erased nodes stay linked until no snapshot can see them anymore, and they
+    	are freed one epoch later, once no reader can still be standing on them.
+	*/
+	template< typename T >
+	class snapshot_list{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef unsigned long long version_type; //!< Type of the list versions.
+			static constexpr size_type initial_size=0; //!< Default value is 0.
+			static constexpr size_type max_readers=64; //!< Number of snapshots that may be alive at once.
+			static constexpr size_type reclaim_threshold=64; //!< Erased nodes kept before the writer tries to reclaim them.
+			static constexpr version_type no_reader=~0ull; //!< Value of a free reader slot.
+
+			//=== Attributes
+			struct Node{
+				T data;
+				std::atomic< Node * > next; //!< Read by snapshots, written by the writer only.
+				Node* prev; //!< Writer only.
+				version_type born; //!< Version that inserted the node.
+				std::atomic< version_type > died; //!< Version that erased the node, 0 while alive.
+				version_type retired; //!< Version at which the node was unlinked.
+				Node* link; //!< Writer only chain of erased and unlinked nodes.
+			};
+
+			size_type m_size; //!< Number of nodes alive at the latest version.
+			Node * head; //!< Head Node pointer.
+			Node * tail; //!< Tail Node pointer.
+			std::atomic< version_type > m_version; //!< Latest published version.
+			mutable std::atomic< version_type > m_readers[max_readers]; //!< Oldest version each snapshot may touch.
+			Node * m_zombies; //!< Erased nodes still linked in the chain.
+			Node * m_retired; //!< Unlinked nodes waiting for the readers to leave.
+			size_type m_pending; //!< Number of nodes in m_zombies and m_retired.
+			size_type m_reclaim_at; //!< Value of m_pending that triggers the next reclaim.
+
+		public:
+			class my_iterator;
+			class snapshot_view;
+
+			//=== Constructors
+			/// Default constructor.
+			snapshot_list( )
+				: m_size{initial_size}, head{new Node}, tail{new Node}, m_version{0},
+				  m_zombies{nullptr}, m_retired{nullptr}, m_pending{0}, m_reclaim_at{reclaim_threshold}
+			{
+				init_sentinel( head );
+				init_sentinel( tail );
+				head->next.store( tail, std::memory_order_relaxed );
+				tail->prev = head;
+
+				for( size_type i{0u} ; i < max_readers ; i++ )
+					m_readers[i].store( no_reader, std::memory_order_relaxed );
+			}
+
+			snapshot_list( const snapshot_list& ) = delete;
+			snapshot_list& operator=( const snapshot_list& ) = delete;
+
+			/// Destructor. No snapshot may outlive the list.
+			~snapshot_list( )
+			{
+				free_chain( m_retired );
+
+				Node * fast = head;
+				while( fast != nullptr )
+				{
+					Node * target = fast;
+					fast = fast->next.load( std::memory_order_relaxed );
+					delete target;
+				}
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item alive at the latest version.
+			my_iterator begin() const
+			{ return my_iterator( skip_dead( head->next.load( std::memory_order_relaxed ) ) ); }
+
+			/// Returns a iterator pointing to the position just after the last item in the list.
+			my_iterator end() const
+			{ return my_iterator( tail ); }
+
+			//=== Methods
+			/// Returns the size of the list at the latest version.
+			size_type size( ) const
+			{return this->m_size;}
+
+			/// Checks if the list is empty.
+			bool empty( ) const
+			{return m_size == 0;}
+
+			/// Returns the latest published version.
+			version_type version( ) const
+			{return m_version.load( std::memory_order_acquire );}
+
+			/// Adds value to the front of the list.
+			void push_front( const T & value )
+			{ insert( begin(), value ); }
+
+			/// Adds value to the end of the list.
+			void push_back( const T & value )
+			{ insert( end(), value ); }
+
+			/// Removes the object at the front of the list.
+			void pop_front( )
+			{
+				if(m_size == 0)
+					return;
+
+				erase( begin() );
+			}
+
+			/// Removes the object at the end of the list.
+			void pop_back( )
+			{
+				if(m_size == 0)
+					return;
+
+				Node * target = tail->prev;
+				while( is_dead( target ) )
+					target = target->prev;
+
+				erase( my_iterator( target ) );
+			}
+
+			/// Returns the object at the beginning of the list.
+			const T & front( ) const
+			{ return *begin(); }
+
+			/// Returns the object at the end of the list.
+			const T & back( ) const
+			{
+				Node * target = tail->prev;
+				while( is_dead( target ) )
+					target = target->prev;
+
+				return target->data;
+			}
+
+			/// Adds value into the list before pos. Returns an iterator to the inserted item.
+			my_iterator insert( my_iterator pos, const T & value )
+			{
+				version_type next_version = m_version.load( std::memory_order_relaxed ) + 1;
+
+				Node * temp = pos.getIt();
+				Node * newNode = new Node;
+
+				newNode->data = value;
+				newNode->born = next_version;
+				newNode->died.store( 0, std::memory_order_relaxed );
+				newNode->prev = temp->prev;
+				newNode->next.store( temp, std::memory_order_relaxed );
+				newNode->link = nullptr;
+
+				temp->prev = newNode;
+				// Publishes the fully built node to the readers.
+				newNode->prev->next.store( newNode, std::memory_order_release );
+
+				m_size++;
+				m_version.store( next_version, std::memory_order_seq_cst );
+
+				return my_iterator( newNode );
+			}
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			my_iterator erase( my_iterator pos )
+			{
+				version_type next_version = m_version.load( std::memory_order_relaxed ) + 1;
+
+				Node * target = pos.getIt();
+				pos++;
+
+				// The node stays linked: older snapshots may still need it.
+				target->died.store( next_version, std::memory_order_release );
+				target->link = m_zombies;
+				m_zombies = target;
+				m_pending++;
+
+				m_size--;
+				m_version.store( next_version, std::memory_order_seq_cst );
+
+				if( m_pending >= m_reclaim_at )
+					reclaim();
+
+				return pos;
+			}
+
+			/// Returns a read-only view of the list at the latest version. Wait-free.
+			snapshot_view snapshot( ) const
+			{
+				// The slot must hold a version no newer than the one the view reads,
+				// and it has to be visible before the view touches any node.
+				version_type oldest = m_version.load( std::memory_order_seq_cst );
+
+				for( size_type i{0u} ; i < max_readers ; i++ )
+				{
+					version_type expected = no_reader;
+					if( m_readers[i].compare_exchange_strong( expected, oldest, std::memory_order_seq_cst ) )
+						return snapshot_view( this, i, m_version.load( std::memory_order_seq_cst ) );
+				}
+
+				throw std::runtime_error("error in snapshot(): too many readers");
+			}
+
+			/// Unlinks the erased nodes no snapshot can see and frees the ones no reader can reach.
+			void reclaim( )
+			{
+				version_type oldest = oldest_reader();
+				version_type current = m_version.load( std::memory_order_relaxed );
+
+				Node * zombies = m_zombies;
+				m_zombies = nullptr;
+				while( zombies != nullptr )
+				{
+					Node * target = zombies;
+					zombies = zombies->link;
+
+					if( target->died.load( std::memory_order_relaxed ) <= oldest )
+					{
+						target->next.load( std::memory_order_relaxed )->prev = target->prev;
+						target->prev->next.store( target->next.load( std::memory_order_relaxed ), std::memory_order_release );
+						target->retired = current;
+						target->link = m_retired;
+						m_retired = target;
+					}
+					else
+					{
+						target->link = m_zombies;
+						m_zombies = target;
+					}
+				}
+
+				// The unlinks above must be visible before the readers are scanned again.
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				oldest = oldest_reader();
+
+				Node * retired = m_retired;
+				m_retired = nullptr;
+				while( retired != nullptr )
+				{
+					Node * target = retired;
+					retired = retired->link;
+
+					if( target->retired < oldest )
+					{
+						delete target;
+						m_pending--;
+					}
+					else
+					{
+						target->link = m_retired;
+						m_retired = target;
+					}
+				}
+
+				// Long lived snapshots keep nodes around, so back off instead of rescanning on every erase.
+				m_reclaim_at = m_pending + reclaim_threshold;
+			}
+
+		private:
+			static void init_sentinel( Node * sentinel )
+			{
+				sentinel->next.store( nullptr, std::memory_order_relaxed );
+				sentinel->prev = nullptr;
+				sentinel->born = 0;
+				sentinel->died.store( 0, std::memory_order_relaxed );
+				sentinel->link = nullptr;
+			}
+
+			static bool is_dead( const Node * node )
+			{ return node->died.load( std::memory_order_relaxed ) != 0; }
+
+			/// Returns the first node alive at the latest version starting from node.
+			static Node * skip_dead( Node * node )
+			{
+				while( node->next.load( std::memory_order_relaxed ) != nullptr and is_dead( node ) )
+					node = node->next.load( std::memory_order_relaxed );
+				return node;
+			}
+
+			/// Returns the oldest version a snapshot may touch, or no_reader if there are none.
+			version_type oldest_reader( ) const
+			{
+				version_type oldest = no_reader;
+				for( size_type i{0u} ; i < max_readers ; i++ )
+				{
+					version_type v = m_readers[i].load( std::memory_order_seq_cst );
+					if( v < oldest )
+						oldest = v;
+				}
+				return oldest;
+			}
+
+			void release_reader( size_type slot ) const
+			{ m_readers[slot].store( no_reader, std::memory_order_release ); }
+
+			static void free_chain( Node * chain )
+			{
+				while( chain != nullptr )
+				{
+					Node * target = chain;
+					chain = chain->link;
+					delete target;
+				}
+			}
+
+	public:
+
+		/*! \class my_iterator
+
+			Writer side iterator, it only visits the items alive at the latest version.
+		*/
+		class my_iterator{
+			private:
+				Node * it; //!< Iterator pointer
+				typedef my_iterator iterator;
+
+			public:
+				//=== Constructor
+				my_iterator(Node * it)
+					: it{it}
+				{/*empty*/}
+
+			public:
+				//=== Operators
+				iterator operator++(void)
+				{
+					it = skip_dead( it->next.load( std::memory_order_relaxed ) );
+					return iterator( it );
+				}
+
+				iterator operator++(int)
+				{
+					iterator temp( it );
+					it = skip_dead( it->next.load( std::memory_order_relaxed ) );
+					return temp;
+				}
+
+				const T & operator*() const
+				{ return it->data; }
+
+				bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+
+				Node * getIt()
+				{ return it; }
+
+		}; // class my_iterator
+
+
+		/*! \class snapshot_view
+
+			Read-only view of the list at the version it was taken. Iterating it never
+			blocks the writer, and the nodes it can reach are not freed until it is destroyed.
+		*/
+		class snapshot_view{
+			private:
+				const snapshot_list * m_list; //!< Owner of the nodes.
+				size_type m_slot; //!< Reader slot held by this view.
+				version_type m_version; //!< Version seen by this view.
+
+				friend class snapshot_list;
+
+				snapshot_view( const snapshot_list * list, size_type slot, version_type version )
+					: m_list{list}, m_slot{slot}, m_version{version}
+				{/*empty*/}
+
+			public:
+				class const_iterator;
+
+				snapshot_view( const snapshot_view& ) = delete;
+				snapshot_view& operator=( const snapshot_view& ) = delete;
+
+				/// Move constructor, the source view no longer holds a reader slot.
+				snapshot_view( snapshot_view&& other )
+					: m_list{other.m_list}, m_slot{other.m_slot}, m_version{other.m_version}
+				{ other.m_list = nullptr; }
+
+				/// Destructor, lets the writer reclaim the nodes this view could see.
+				~snapshot_view( )
+				{
+					if( m_list != nullptr )
+						m_list->release_reader( m_slot );
+				}
+
+				/// Returns the version seen by this view.
+				version_type version( ) const
+				{ return m_version; }
+
+				/// Returns an iterator pointing to the first item of the snapshot.
+				const_iterator begin( ) const
+				{ return const_iterator( m_list->head->next.load( std::memory_order_acquire ), m_version ); }
+
+				/// Returns an iterator pointing to the position just after the last item of the snapshot.
+				const_iterator end( ) const
+				{ return const_iterator( m_list->tail, m_version ); }
+
+				/// Counts the items of the snapshot.
+				size_type size( ) const
+				{
+					size_type count = 0;
+					for( const_iterator it = begin() ; it != end() ; ++it )
+						count++;
+					return count;
+				}
+
+			/*! \class const_iterator
+
+				Forward iterator over the items alive at the version of the view.
+			*/
+			class const_iterator{
+				private:
+					const Node * it; //!< Iterator pointer
+					version_type m_version; //!< Version seen by the iterator.
+					typedef const_iterator iterator;
+
+					void skip( )
+					{
+						while( it->next.load( std::memory_order_acquire ) != nullptr and not visible( it ) )
+							it = it->next.load( std::memory_order_acquire );
+					}
+
+					bool visible( const Node * node ) const
+					{
+						version_type died = node->died.load( std::memory_order_acquire );
+						return node->born <= m_version and ( died == 0 or died > m_version );
+					}
+
+				public:
+					//=== Constructor
+					const_iterator( const Node * it, version_type version )
+						: it{it}, m_version{version}
+					{ skip(); }
+
+				public:
+					//=== Operators
+					iterator operator++(void)
+					{
+						it = it->next.load( std::memory_order_acquire );
+						skip();
+						return *this;
+					}
+
+					iterator operator++(int)
+					{
+						iterator temp( *this );
+						++(*this);
+						return temp;
+					}
+
+					const T & operator*() const
+					{ return it->data; }
+
+					bool operator==( const iterator& it2) const
+					{ return it == it2.it; }
+
+					bool operator!=( const iterator& it2) const
+					{ return it != it2.it; }
+			}; // class const_iterator
+
+		}; // class snapshot_view
+
+	}; // class snapshot_list
+
+} // namespace sc
+
+#endif
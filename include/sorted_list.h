@@ -0,0 +1,224 @@
+#ifndef SORTED_LIST_H
+#define SORTED_LIST_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "list.h"
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+
+	/*! \class sorted_list
+    	\brief sc::list kept sorted by Compare, searched from a finger.
+
+    	Every search starts at the finger, the node of the last insertion or lookup,
+    	and gallops towards the target: it compares the nodes 1, 2, 4... away, then
+    	bisects the last step. A target d nodes away costs O(log d) comparisons, the
+    	links are still followed one by one, O(d) of them. Inserting a nearly sorted
+    	stream therefore only moves the finger a few nodes per element, which is
+    	amortized O(1). Equal elements keep their insertion order.
+	*/
+	template< typename T, typename Compare = std::less< T > >
+	class sorted_list{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef typename list< T >::my_iterator my_iterator; //!< Iterator of the underlying list.
+
+			//=== Attributes
+			list< T > m_list; //!< Elements, in order.
+			my_iterator m_finger; //!< Where the next search starts.
+			Compare m_comp; //!< Strict weak ordering of the elements.
+
+		public:
+			//=== Constructors
+			/// Default constructor.
+			explicit sorted_list( Compare comp = Compare() )
+				: m_list{}, m_finger{ m_list.end() }, m_comp{comp}
+			{/*empty*/}
+
+			/// std::initializer_list constructor, the elements may come in any order.
+			sorted_list( std::initializer_list<T> ilist, Compare comp = Compare() )
+				: sorted_list( comp )
+			{ insert_sorted( ilist.begin(), ilist.end() ); }
+
+			/// Copy constructor.
+			sorted_list( const sorted_list& other )
+				: m_list( other.m_list ), m_finger{ m_list.end() }, m_comp{ other.m_comp }
+			{/*empty*/}
+
+			sorted_list& operator=( const sorted_list& other )
+			{
+				m_list = other.m_list;
+				m_finger = m_list.end();
+				m_comp = other.m_comp;
+				return *this;
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the smallest item.
+			my_iterator begin()
+			{ return m_list.begin(); }
+
+			/// Returns a iterator pointing to the position just after the largest item.
+			my_iterator end()
+			{ return m_list.end(); }
+
+			//=== Methods
+			/// Returns the size of the list.
+			size_type size( ) const
+			{ return m_list.size(); }
+
+			/// Checks if the list is empty.
+			bool empty( )
+			{ return m_list.empty(); }
+
+			/// Returns the smallest element.
+			const T & front( ) const
+			{ return m_list.front(); }
+
+			/// Returns the largest element.
+			const T & back( ) const
+			{ return m_list.back(); }
+
+			/// Delete all the elements.
+			void clear( )
+			{
+				m_list.clear();
+				m_finger = m_list.end();
+			}
+
+			/// Returns the first element not less than value. Moves the finger there.
+			my_iterator lower_bound( const T & value )
+			{
+				m_finger = gallop( [&]( const T & e ){ return m_comp( e, value ); } );
+				return m_finger;
+			}
+
+			/// Returns the first element greater than value. Moves the finger there.
+			my_iterator upper_bound( const T & value )
+			{
+				m_finger = gallop( [&]( const T & e ){ return not m_comp( value, e ); } );
+				return m_finger;
+			}
+
+			/// Inserts value after the elements equivalent to it. Returns an iterator to the inserted item.
+			my_iterator insert_sorted( const T & value )
+			{
+				my_iterator pos = upper_bound( value );
+				m_list.insert( pos, value );
+
+				m_finger = pos - 1;
+				return m_finger;
+			}
+
+			/// Inserts the elements in [first; last): sorts them, then merges them in a single pass over the list.
+			template< typename InItr >
+			void insert_sorted( InItr first, InItr last )
+			{
+				std::vector< T > batch( first, last );
+				if( batch.empty() )
+					return;
+
+				std::stable_sort( batch.begin(), batch.end(), m_comp );
+
+				my_iterator pos = begin();
+				for( const T & e : batch )
+				{
+					while( pos != end() and not m_comp( e, *pos ) )
+						++pos;
+					m_list.insert( pos, e );
+				}
+
+				m_finger = pos - 1;
+			}
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			my_iterator erase( my_iterator pos )
+			{
+				bool at_finger = pos == m_finger;
+				my_iterator next = m_list.erase( pos );
+				if( at_finger )
+					m_finger = next;
+
+				return next;
+			}
+
+			/// Removes the smallest element.
+			void pop_front( )
+			{
+				if( not m_list.empty() )
+					erase( begin() );
+			}
+
+			/// Removes the largest element.
+			void pop_back( )
+			{
+				if( not m_list.empty() )
+					erase( end() - 1 );
+			}
+
+		private:
+			/// Returns the first element for which before is false, before being true on a prefix of the list.
+			template< typename Before >
+			my_iterator gallop( Before before )
+			{
+				// Brackets the boundary between lo, where before holds, and hi, gap nodes further, where it
+				// doesn't or which is end().
+				my_iterator lo = m_finger;
+				my_iterator hi = m_finger;
+				size_type gap = 0;
+				if( hi != end() and before( *hi ) )
+				{
+					for( size_type step = 1 ; ; step *= 2 )
+					{
+						for( gap = 0 ; gap < step and hi != end() ; ++gap )
+							++hi;
+						if( hi == end() or not before( *hi ) )
+							break;
+						lo = hi;
+					}
+				}
+				else
+				{
+					for( size_type step = 1 ; ; step *= 2 )
+					{
+						if( hi == begin() )
+							return hi;
+						for( gap = 0 ; gap < step and lo != begin() ; ++gap )
+							--lo;
+						if( before( *lo ) )
+							break;
+						hi = lo;
+					}
+				}
+
+				while( gap > 1 )
+				{
+					size_type half = gap / 2;
+					my_iterator mid = lo;
+					for( size_type i = 0 ; i < half ; ++i )
+						++mid;
+
+					if( before( *mid ) )
+					{
+						lo = mid;
+						gap -= half;
+					}
+					else
+					{
+						hi = mid;
+						gap = half;
+					}
+				}
+				return hi;
+			}
+	}; // class sorted_list
+
+} // namespace sc
+
+#endif
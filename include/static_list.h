@@ -0,0 +1,253 @@
+#ifndef STATIC_LIST_H
+#define STATIC_LIST_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+
+	/*! \class static_list
+    	\brief doubly linked list of at most N elements stored inline.
+
+    	The nodes live in an array inside the object and are linked by index, slot N
+    	being the sentinel. Nothing is allocated, so a static_list is a literal type:
+    	it can be built and used in constant expressions and kept as a constexpr object.
+	*/
+	template< typename T, size_t N >
+	class static_list{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			static constexpr size_type sentinel=N; //!< Slot linking the last element back to the first.
+
+			//=== Attributes
+			struct Slot{
+				T data;
+				size_type next;
+				size_type prev;
+			};
+
+			Slot m_slots[N + 1]; //!< Element slots followed by the sentinel.
+			size_type m_size; //!< size of the list.
+			size_type m_free; //!< First unused slot, unused slots are linked through next.
+
+		public:
+			class my_iterator;
+
+			//=== Constructors
+			/// Default constructor.
+			constexpr static_list( )
+				: m_slots{}, m_size{0}, m_free{0}
+			{
+				// The last unused slot points to the sentinel, which ends the free chain.
+				for( size_type i{0u} ; i < N ; i++ )
+					m_slots[i].next = i + 1;
+
+				m_slots[sentinel].next = sentinel;
+				m_slots[sentinel].prev = sentinel;
+			}
+
+			/// std::initializer_list constructor.
+			constexpr static_list( std::initializer_list<T> ilist )
+				: static_list()
+			{
+				for( const T& e : ilist )
+					push_back( e );
+			}
+
+			/// Constructor with elements in [first, last) range.
+			template< typename InputIt >
+			constexpr static_list( InputIt first, InputIt last )
+				: static_list()
+			{
+				for( ; first != last ; ++first )
+					push_back( *first );
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item in the list.
+			constexpr my_iterator begin() const
+			{ return my_iterator( this, m_slots[sentinel].next ); }
+
+			/// Returns a iterator pointing to the position just after the last item in the list.
+			constexpr my_iterator end() const
+			{ return my_iterator( this, sentinel ); }
+
+			//=== Methods
+			/// Returns the size of the list.
+			constexpr size_type size( ) const
+			{ return m_size; }
+
+			/// Returns the number of elements the list can hold.
+			constexpr size_type capacity( ) const
+			{ return N; }
+
+			/// Checks if the list is empty.
+			constexpr bool empty( ) const
+			{ return m_size == 0; }
+
+			/// Checks if no element can be added.
+			constexpr bool full( ) const
+			{ return m_size == N; }
+
+			/// Delete all the elements.
+			constexpr void clear( )
+			{
+				while( not empty() )
+					pop_front();
+			}
+
+			/// Returns the object at the beginning of the list.
+			constexpr const T & front( ) const
+			{ return m_slots[ m_slots[sentinel].next ].data; }
+
+			/// Returns the object at the end of the list.
+			constexpr const T & back( ) const
+			{ return m_slots[ m_slots[sentinel].prev ].data; }
+
+			/// Adds value to the front of the list.
+			constexpr void push_front( const T & value )
+			{ insert( begin(), value ); }
+
+			/// Adds value to the end of the list.
+			constexpr void push_back( const T & value )
+			{ insert( end(), value ); }
+
+			/// Removes the object at the front of the list.
+			constexpr void pop_front( )
+			{
+				if( m_size != 0 )
+					erase( begin() );
+			}
+
+			/// Removes the object at the end of the list.
+			constexpr void pop_back( )
+			{
+				if( m_size != 0 )
+					erase( my_iterator( this, m_slots[sentinel].prev ) );
+			}
+
+			/// Adds value into the list before pos. Returns an iterator to the inserted item.
+			constexpr my_iterator insert( my_iterator pos, const T & value )
+			{
+				if( full() )
+					throw std::length_error("error in insert(): static_list is full");
+
+				size_type slot = m_free;
+				m_free = m_slots[slot].next;
+
+				size_type after = pos.getIt();
+				m_slots[slot].data = value;
+				m_slots[slot].next = after;
+				m_slots[slot].prev = m_slots[after].prev;
+				m_slots[ m_slots[after].prev ].next = slot;
+				m_slots[after].prev = slot;
+				m_size++;
+
+				return my_iterator( this, slot );
+			}
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			constexpr my_iterator erase( my_iterator pos )
+			{
+				size_type slot = pos.getIt();
+				size_type after = m_slots[slot].next;
+
+				m_slots[ m_slots[slot].prev ].next = after;
+				m_slots[after].prev = m_slots[slot].prev;
+
+				m_slots[slot].next = m_free;
+				m_free = slot;
+				m_size--;
+
+				return my_iterator( this, after );
+			}
+
+			/// Operator== overload for lists comparison
+			constexpr bool operator==( const static_list& rhs ) const
+			{
+				if( m_size != rhs.m_size )
+					return false;
+
+				for( my_iterator mine = begin(), theirs = rhs.begin() ; mine != end() ; ++mine, ++theirs )
+				{
+					if( *mine != *theirs )
+						return false;
+				}
+				return true;
+			}
+
+			/// Operator!= overload for lists comparison
+			constexpr bool operator!=( const static_list& rhs ) const
+			{ return not ( *this == rhs ); }
+
+	public:
+
+		/*! \class my_iterator
+
+			Bidirectional iterator over a static_list, a slot index with the list it belongs to.
+		*/
+		class my_iterator{
+			private:
+				const static_list * owner; //!< List the slot belongs to.
+				size_type it; //!< Slot index.
+				typedef my_iterator iterator;
+
+			public:
+				//=== Constructor
+				constexpr my_iterator( const static_list * owner, size_type it )
+					: owner{owner}, it{it}
+				{/*empty*/}
+
+			public:
+				//=== Operators
+				constexpr iterator operator++(void)
+				{
+					it = owner->m_slots[it].next;
+					return *this;
+				}
+
+				constexpr iterator operator++(int)
+				{
+					iterator temp( *this );
+					it = owner->m_slots[it].next;
+					return temp;
+				}
+
+				constexpr iterator operator--(void)
+				{
+					it = owner->m_slots[it].prev;
+					return *this;
+				}
+
+				constexpr iterator operator--(int)
+				{
+					iterator temp( *this );
+					it = owner->m_slots[it].prev;
+					return temp;
+				}
+
+				constexpr const T & operator*() const
+				{ return owner->m_slots[it].data; }
+
+				constexpr bool operator==( const iterator& it2) const
+				{ return it == it2.it; }
+
+				constexpr bool operator!=( const iterator& it2) const
+				{ return it != it2.it; }
+
+				constexpr size_type getIt() const
+				{ return it; }
+
+		}; // class my_iterator
+
+	}; // class static_list
+
+} // namespace sc
+
+#endif
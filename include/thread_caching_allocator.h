@@ -0,0 +1,275 @@
+#ifndef THREAD_CACHING_ALLOCATOR_H
+#define THREAD_CACHING_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \struct node_cache_stats
+		\brief counters of all the node_caches of the process, whatever their block size.
+	*/
+	struct node_cache_stats{
+		size_t slabs; //!< Slabs of magazine_size blocks obtained from operator new.
+		size_t refills; //!< Magazines handed from a depot to a thread.
+		size_t returns; //!< Magazines handed from a thread back to a depot.
+		size_t depot_magazines; //!< Magazines in the depots right now.
+	};
+
+	/// Live counters behind node_cache_stats, updated by the depots only.
+	struct node_cache_counters{
+		std::atomic< size_t > slabs;
+		std::atomic< size_t > refills;
+		std::atomic< size_t > returns;
+		std::atomic< size_t > depot_magazines;
+
+		/// Returns the counters of the process.
+		static node_cache_counters & instance( )
+		{
+			static node_cache_counters counters{ {0}, {0}, {0}, {0} };
+			return counters;
+		}
+
+		node_cache_stats snapshot( ) const
+		{
+			return node_cache_stats{ slabs.load( std::memory_order_relaxed ), refills.load( std::memory_order_relaxed ),
+				returns.load( std::memory_order_relaxed ), depot_magazines.load( std::memory_order_relaxed ) };
+		}
+	};
+
+
+	/*! \class node_cache
+    	\brief per-thread magazines of free blocks of Size bytes, backed by a global depot.
+
+    	Each thread keeps two magazines (stacks of up to magazine_size free blocks)
+    	and allocates and frees from them without any lock. Only when both are empty
+    	does it take a magazine from the depot, which cuts new ones out of a slab, and
+    	only when both hold blocks and the loaded one is full does it give one back.
+    	A block may be freed by any thread: it joins that thread's magazines and
+    	reaches the others through the depot. A thread returns its magazines to the
+    	depot when it exits.
+
+    	Slabs are only released when the process exits, so objects using the cache
+    	must not outlive the main thread's thread_local objects.
+	*/
+	template< size_t Size, size_t Align >
+	class node_cache{
+		private:
+			//=== Alias
+			static constexpr size_t magazine_size=64; //!< Blocks per magazine, also per slab.
+			static constexpr size_t alignment=Align < alignof( void * ) ? alignof( void * ) : Align; //!< Alignment of the blocks.
+			static constexpr size_t block_size=( ( Size < sizeof( void * ) ? sizeof( void * ) : Size ) + alignment - 1 ) / alignment * alignment; //!< Bytes per block.
+
+			//=== Attributes
+			/// A free block, linked to the next one in its magazine.
+			struct Block{
+				Block * next;
+			};
+
+			/// A stack of free blocks.
+			struct Magazine{
+				Block * top;
+				size_t count;
+			};
+
+			/// Magazines shared by all the threads.
+			class Depot{
+				private:
+					std::mutex m_mutex; //!< Guards the magazines and the slabs.
+					std::vector< Magazine > m_full; //!< Magazines given back, not empty.
+					std::vector< void * > m_slabs; //!< Every slab, freed at exit.
+					node_cache_counters & m_counters; //!< Counters of the process.
+
+				public:
+					Depot( )
+						: m_counters( node_cache_counters::instance() )
+					{/*empty*/}
+
+					~Depot( )
+					{
+						for( void * slab : m_slabs )
+							::operator delete( slab, std::align_val_t( alignment ) );
+					}
+
+					/// Returns a magazine given back by a thread, or a full one cut from a new slab.
+					Magazine take( )
+					{
+						std::lock_guard< std::mutex > lock( m_mutex );
+						m_counters.refills.fetch_add( 1, std::memory_order_relaxed );
+
+						if( not m_full.empty() )
+						{
+							Magazine full = m_full.back();
+							m_full.pop_back();
+							m_counters.depot_magazines.fetch_sub( 1, std::memory_order_relaxed );
+							return full;
+						}
+
+						char * slab = static_cast< char * >( ::operator new( block_size * magazine_size, std::align_val_t( alignment ) ) );
+						m_slabs.push_back( slab );
+						m_counters.slabs.fetch_add( 1, std::memory_order_relaxed );
+
+						Magazine full{ nullptr, magazine_size };
+						for( size_t i{0u} ; i < magazine_size ; i++ )
+						{
+							Block * block = reinterpret_cast< Block * >( slab + i * block_size );
+							block->next = full.top;
+							full.top = block;
+						}
+						return full;
+					}
+
+					/// Keeps magazine, which is not empty, for the other threads.
+					void give( Magazine magazine )
+					{
+						std::lock_guard< std::mutex > lock( m_mutex );
+						m_full.push_back( magazine );
+						m_counters.returns.fetch_add( 1, std::memory_order_relaxed );
+						m_counters.depot_magazines.fetch_add( 1, std::memory_order_relaxed );
+					}
+			};
+
+			/// The magazines of one thread.
+			struct Local{
+				Magazine loaded; //!< Blocks are allocated from and freed to this one.
+				Magazine previous; //!< Swapped with loaded before going to the depot.
+
+				/// Gives the blocks back to the depot when the thread exits.
+				~Local( )
+				{ flush( *this ); }
+			};
+
+			static Depot & depot( )
+			{
+				static Depot global;
+				return global;
+			}
+
+			static Local & local( )
+			{
+				static thread_local Local magazines{ { nullptr, 0 }, { nullptr, 0 } };
+				return magazines;
+			}
+
+			static void flush( Local & cache )
+			{
+				if( cache.loaded.count > 0 )
+					depot().give( cache.loaded );
+				if( cache.previous.count > 0 )
+					depot().give( cache.previous );
+				cache.loaded = Magazine{ nullptr, 0 };
+				cache.previous = Magazine{ nullptr, 0 };
+			}
+
+		public:
+			/// Returns a block of Size bytes aligned on Align.
+			static void * allocate( )
+			{
+				Local & cache = local();
+				if( cache.loaded.count == 0 )
+				{
+					if( cache.previous.count > 0 )
+						std::swap( cache.loaded, cache.previous );
+					else
+						cache.loaded = depot().take();
+				}
+
+				Block * block = cache.loaded.top;
+				cache.loaded.top = block->next;
+				cache.loaded.count--;
+				return block;
+			}
+
+			/// Frees a block returned by allocate(), possibly on another thread.
+			static void deallocate( void * pointer )
+			{
+				Local & cache = local();
+				if( cache.loaded.count == magazine_size )
+				{
+					if( cache.previous.count > 0 )
+						depot().give( cache.previous );
+					cache.previous = cache.loaded;
+					cache.loaded = Magazine{ nullptr, 0 };
+				}
+
+				Block * block = static_cast< Block * >( pointer );
+				block->next = cache.loaded.top;
+				cache.loaded.top = block;
+				cache.loaded.count++;
+			}
+
+			/// Gives the free blocks of the calling thread back to the depot.
+			static void flush( )
+			{ flush( local() ); }
+
+	}; // class node_cache
+
+
+	/*! \class thread_caching_allocator
+    	\brief allocator serving single objects from the calling thread's node_cache.
+
+    	Meant for node based containers, e.g. sc::list< T, sc::thread_caching_allocator< T > >:
+    	every node comes from a per-thread magazine, so threads building and destroying
+    	their own lists don't contend on the global heap. Arrays go to operator new.
+	*/
+	template< typename T >
+	class thread_caching_allocator{
+		private:
+			typedef node_cache< sizeof( T ), alignof( T ) > cache; //!< Cache of the blocks of T.
+
+		public:
+			//=== Alias
+			typedef T value_type; //!< Type of the allocated objects.
+			typedef std::true_type is_always_equal; //!< Stateless, any instance frees what another allocated.
+			typedef std::true_type propagate_on_container_move_assignment; //!< Nothing to propagate.
+
+			//=== Constructors
+			thread_caching_allocator( ) noexcept = default;
+
+			template< typename U >
+			thread_caching_allocator( const thread_caching_allocator< U > & ) noexcept
+			{/*empty*/}
+
+			//=== Methods
+			/// Allocates room for n objects of T.
+			T * allocate( size_t n )
+			{
+				if( n == 1 )
+					return static_cast< T * >( cache::allocate() );
+				return std::allocator< T >().allocate( n );
+			}
+
+			/// Frees p, obtained from allocate( n ).
+			void deallocate( T * p, size_t n )
+			{
+				if( n == 1 )
+					cache::deallocate( p );
+				else
+					std::allocator< T >().deallocate( p, n );
+			}
+
+			/// Returns the counters of all the caches, they serve the nodes of any type.
+			static node_cache_stats stats( )
+			{ return node_cache_counters::instance().snapshot(); }
+
+			/// Gives the free blocks of T cached by the calling thread back to the depot.
+			static void flush( )
+			{ cache::flush(); }
+
+			template< typename U >
+			bool operator==( const thread_caching_allocator< U > & ) const noexcept
+			{ return true; }
+	}; // class thread_caching_allocator
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef TRAVERSAL_PROFILER_H
+#define TRAVERSAL_PROFILER_H
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <source_location>
+#include <unordered_map>
+#include <vector>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \struct traced
+		\brief an index or offset that remembers the call site it was written at.
+
+		The location is a default argument of the converting constructor, so it is
+		taken where the caller passes a plain number, e.g. the line of seq[i].
+	*/
+	template< typename N >
+	struct traced{
+		N value; //!< The index or offset itself.
+		std::source_location where; //!< Call site.
+
+		constexpr traced( N value, std::source_location where = std::source_location::current() )
+			: value{value}, where{where}
+		{/*empty*/}
+	};
+
+	/*! \struct traversal_site
+		\brief node hops counted at one call site.
+	*/
+	struct traversal_site{
+		const char * file; //!< Source file of the call site.
+		unsigned line; //!< Line of the call site.
+		const char * function; //!< Function the call site is in.
+		size_t calls; //!< Number of calls.
+		size_t hops; //!< Nodes walked by all the calls.
+		size_t min_hops; //!< Shortest walk of a single call.
+		size_t max_hops; //!< Longest walk of a single call.
+		size_t sizes; //!< Sum of the list sizes seen by the calls, 0 when unknown (iterator arithmetic).
+		bool linear; //!< Whether the walks scale with the size of the list.
+	};
+
+
+	/*! \class traversal_profiler
+		\brief counts the node hops hidden in operator[], at() and iterator arithmetic, per call site.
+
+		Only fed when SC_LIST_PROFILE is defined. A call site is flagged as linear when
+		its walks cover at least a quarter of the list on average, on lists of at least
+		min_linear_size elements. Iterator arithmetic doesn't know its list, so there a
+		site is flagged when its walks reach min_linear_size nodes and their length
+		varies between calls, as with an offset that follows a loop index: a fixed
+		offset like begin() + 150 costs the same whatever the size. A flagged site
+		inside a loop over the list is a quadratic loop.
+
+		Every thread counts into its own table, merged when the sites are read, so
+		profiled walks on different threads don't contend.
+	*/
+	class traversal_profiler{
+		private:
+			//=== Alias
+			static constexpr size_t min_linear_size=64; //!< Shorter walks are never flagged.
+
+			//=== Attributes
+			struct Key{
+				const char * file;
+				unsigned line;
+				unsigned column;
+			};
+
+			struct KeyLess{
+				bool operator()( const Key & a, const Key & b ) const
+				{
+					if( a.line != b.line )
+						return a.line < b.line;
+					if( a.column != b.column )
+						return a.column < b.column;
+					return std::strcmp( a.file, b.file ) < 0;
+				}
+			};
+
+			/// Hashes a call site by the address of its file name, the same file may show up under several.
+			struct KeyHash{
+				size_t operator()( const Key & key ) const
+				{ return std::hash< const void * >{}( key.file ) ^ ( size_t{key.line} << 12 ) ^ key.column; }
+			};
+
+			struct KeySame{
+				bool operator()( const Key & a, const Key & b ) const
+				{ return a.file == b.file and a.line == b.line and a.column == b.column; }
+			};
+
+			typedef std::map< Key, traversal_site, KeyLess > site_map; //!< Merged counters, ordered by call site.
+
+			/// Counters of the walks of one thread. Only its mutex is taken on record(), and nobody else's
+			/// thread waits on it but a reader of the sites.
+			struct thread_table{
+				traversal_profiler & owner;
+				std::mutex mutex; //!< Guards sites.
+				std::unordered_map< Key, traversal_site, KeyHash, KeySame > sites; //!< Counters of every call site.
+
+				explicit thread_table( traversal_profiler & owner )
+					: owner{owner}
+				{ owner.attach( this ); }
+
+				~thread_table( )
+				{ owner.detach( this ); }
+			};
+
+			std::mutex m_mutex; //!< Guards the fields below.
+			std::vector< thread_table * > m_threads; //!< Tables of the running threads.
+			site_map m_retired; //!< Counters of the threads that have exited.
+			std::ostream * m_exit_report; //!< Where the report goes at exit, nullptr for nowhere.
+
+			traversal_profiler( )
+				: m_exit_report{ &std::cerr }
+			{/*empty*/}
+
+			static bool linear( const traversal_site & site )
+			{
+				if( site.sizes == 0 )
+					return site.hops >= min_linear_size * site.calls and site.max_hops >= 2 * site.min_hops + min_linear_size;
+
+				return site.sizes >= min_linear_size * site.calls and 4 * site.hops >= site.sizes;
+			}
+
+			/// Adds the counters of from into to.
+			static void merge( traversal_site & to, const traversal_site & from )
+			{
+				to.calls += from.calls;
+				to.hops += from.hops;
+				to.min_hops = std::min( to.min_hops, from.min_hops );
+				to.max_hops = std::max( to.max_hops, from.max_hops );
+				to.sizes += from.sizes;
+			}
+
+			/// Adds the counters of table into sites. The table must be locked.
+			template< typename Table >
+			static void merge_into( site_map & sites, const Table & table )
+			{
+				for( const auto & entry : table )
+				{
+					auto found = sites.find( entry.first );
+					if( found == sites.end() )
+						sites.emplace( entry.first, entry.second );
+					else
+						merge( found->second, entry.second );
+				}
+			}
+
+			void attach( thread_table * table )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_threads.push_back( table );
+			}
+
+			/// Keeps the counters of an exiting thread.
+			void detach( thread_table * table )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_threads.erase( std::find( m_threads.begin(), m_threads.end(), table ) );
+				merge_into( m_retired, table->sites );
+			}
+
+			/// Returns the counters of every thread, merged per call site.
+			site_map merged( )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				site_map sites = m_retired;
+				for( thread_table * table : m_threads )
+				{
+					std::lock_guard< std::mutex > table_lock( table->mutex );
+					merge_into( sites, table->sites );
+				}
+				return sites;
+			}
+
+		public:
+			traversal_profiler( const traversal_profiler& ) = delete;
+			traversal_profiler& operator=( const traversal_profiler& ) = delete;
+
+			/// Writes the report of the process, unless report_at_exit( nullptr ) was called.
+			~traversal_profiler( )
+			{
+				if( m_exit_report != nullptr and not merged().empty() )
+					report( *m_exit_report );
+			}
+
+			/// Returns the process wide profiler.
+			static traversal_profiler & instance( )
+			{
+				static traversal_profiler profiler;
+				return profiler;
+			}
+
+			/// Counts a call at where that walked hops nodes of a list of size elements (0 when unknown).
+			void record( const std::source_location & where, size_t hops, size_t size )
+			{
+				thread_local thread_table local( *this );
+				std::lock_guard< std::mutex > lock( local.mutex );
+
+				Key key{ where.file_name(), static_cast< unsigned >( where.line() ), static_cast< unsigned >( where.column() ) };
+				auto found = local.sites.find( key );
+				if( found == local.sites.end() )
+					found = local.sites.emplace( key, traversal_site{ where.file_name(), key.line, where.function_name(), 0, 0, hops, 0, 0, false } ).first;
+
+				traversal_site & site = found->second;
+				site.calls++;
+				site.hops += hops;
+				site.min_hops = std::min( site.min_hops, hops );
+				site.max_hops = std::max( site.max_hops, hops );
+				site.sizes += size;
+			}
+
+			/// Returns the counters of every call site, the most expensive first.
+			std::vector< traversal_site > sites( )
+			{
+				std::vector< traversal_site > ranked;
+				for( const auto & entry : merged() )
+					ranked.push_back( entry.second );
+
+				for( traversal_site & site : ranked )
+					site.linear = linear( site );
+
+				std::stable_sort( ranked.begin(), ranked.end(),
+					[]( const traversal_site & a, const traversal_site & b ){ return a.hops > b.hops; } );
+
+				return ranked;
+			}
+
+			/// Writes the call sites, the most expensive first, to os.
+			void report( std::ostream & os )
+			{
+				os << "sc::list traversal profile, node hops per call site:\n";
+				os << std::setw( 14 ) << "hops" << std::setw( 12 ) << "calls" << std::setw( 12 ) << "hops/call"
+				   << std::setw( 12 ) << "size/call" << "  site\n";
+
+				for( const traversal_site & site : sites() )
+				{
+					os << std::setw( 14 ) << site.hops << std::setw( 12 ) << site.calls
+					   << std::setw( 12 ) << site.hops / site.calls;
+					if( site.sizes == 0 )
+						os << std::setw( 12 ) << "?";
+					else
+						os << std::setw( 12 ) << site.sizes / site.calls;
+					os << "  " << site.file << ":" << site.line << " " << site.function;
+					if( site.linear )
+						os << "  [O(n) walk]";
+					os << "\n";
+				}
+			}
+
+			/// Sets where the report goes at exit, nullptr to skip it.
+			void report_at_exit( std::ostream * os )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_exit_report = os;
+			}
+
+			/// Forgets every call site.
+			void reset( )
+			{
+				std::lock_guard< std::mutex > lock( m_mutex );
+				m_retired.clear();
+				for( thread_table * table : m_threads )
+				{
+					std::lock_guard< std::mutex > table_lock( table->mutex );
+					table->sites.clear();
+				}
+			}
+	}; // class traversal_profiler
+
+} // namespace sc
+
+#endif
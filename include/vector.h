@@ -0,0 +1,596 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+	/*! \class vector
+    	\brief contiguous companion of sc::list, with the same interface.
+
+    	Code written against sc::list (push_back, insert, erase, at, operator[],
+    	assign, remove_if, sort, iterators...) compiles unchanged against sc::vector,
+    	so a hot path doing random access can switch containers by changing a typedef.
+    	Iterators are plain pointers and, unlike the list's, are invalidated by any
+    	reallocation and by insertions and erasures before them.
+
+    	Capacity grows geometrically, doubling when full. Reallocation relocates the
+    	elements with memcpy when T is trivially copyable, moves them when T's move
+    	constructor can't throw and copies them otherwise, so a throwing copy leaves
+    	the vector as it was.
+	*/
+	template< typename T, typename Allocator = std::allocator< T > >
+	class vector{
+		private:
+			//=== Alias
+			typedef size_t size_type; //!< Type of size.
+			typedef std::ptrdiff_t difference_type; //!< Type of the distance between iterators.
+			typedef std::allocator_traits< Allocator > alloc_traits; //!< Interface of the allocator.
+			static constexpr size_type initial_size=0; //!< Default value is 0.
+			static constexpr size_type min_capacity=4; //!< Capacity of the first allocation.
+
+			//=== Attributes
+			[[no_unique_address]] Allocator m_alloc; //!< Source of the storage.
+			T * m_first; //!< First element.
+			T * m_last; //!< Past the last element.
+			T * m_end; //!< Past the end of the storage.
+
+		public:
+			//=== Standard container alias
+			typedef T value_type; //!< Type of the elements.
+			typedef T & reference; //!< Reference to an element.
+			typedef const T & const_reference; //!< Read-only reference to an element.
+			typedef T * iterator; //!< Contiguous iterator.
+			typedef const T * const_iterator; //!< Read-only contiguous iterator.
+			typedef Allocator allocator_type; //!< Allocator the storage is obtained from.
+
+			//=== Constructors
+			/// Default constructor, doesn't allocate.
+			vector( )
+				: m_first{nullptr}, m_last{nullptr}, m_end{nullptr}
+			{/*empty*/}
+
+			/// Empty vector allocating its storage from alloc.
+			explicit vector( const Allocator & alloc )
+				: m_alloc( alloc ), m_first{nullptr}, m_last{nullptr}, m_end{nullptr}
+			{/*empty*/}
+
+			/// Vector of count value-initialized elements.
+			explicit vector( size_type count )
+				: vector()
+			{
+				resize( count );
+			}
+
+			/// Vector with the elements of [first; last).
+			template< typename InputIt, typename = typename std::iterator_traits< InputIt >::iterator_category >
+			vector( InputIt first, InputIt last )
+				: vector()
+			{
+				insert( end(), first, last );
+			}
+
+			/// Copy constructor.
+			vector( const vector& other )
+				: m_alloc( alloc_traits::select_on_container_copy_construction( other.m_alloc ) ), m_first{nullptr}, m_last{nullptr}, m_end{nullptr}
+			{
+				reserve( other.size() );
+				for( const T & value : other )
+					alloc_traits::construct( m_alloc, m_last++, value );
+			}
+
+			/// Move constructor, takes the storage of other and leaves it empty.
+			vector( vector&& other ) noexcept
+				: m_alloc( std::move( other.m_alloc ) ), m_first{other.m_first}, m_last{other.m_last}, m_end{other.m_end}
+			{
+				other.m_first = other.m_last = other.m_end = nullptr;
+			}
+
+			/// Vector with the elements of ilist.
+			vector( std::initializer_list<T> ilist )
+				: vector( ilist.begin(), ilist.end() )
+			{/*empty*/}
+
+			/// Destructor.
+			~vector( )
+			{
+				release();
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first item in the vector.
+			iterator begin()
+			{ return m_first; }
+
+			/// Returns an iterator pointing to the end mark in the vector.
+			iterator end()
+			{ return m_last; }
+
+			const_iterator begin() const
+			{ return m_first; }
+
+			const_iterator end() const
+			{ return m_last; }
+
+			const_iterator cbegin() const
+			{ return m_first; }
+
+			const_iterator cend() const
+			{ return m_last; }
+
+			//=== Methods
+			/// Returns the number of elements in the vector.
+			size_type size( ) const
+			{ return m_last - m_first; }
+
+			/// Returns a copy of the allocator.
+			allocator_type get_allocator( ) const
+			{ return m_alloc; }
+
+			/// Returns the number of elements the vector can hold before reallocating.
+			size_type capacity( ) const
+			{ return m_end - m_first; }
+
+			/// Returns a pointer to the storage of the elements.
+			T * data( )
+			{ return m_first; }
+
+			const T * data( ) const
+			{ return m_first; }
+
+			/// Reallocates, if needed, so that the vector can hold new_cap elements without reallocating.
+			void reserve( size_type new_cap )
+			{
+				if( new_cap > capacity() )
+					reallocate( new_cap );
+			}
+
+			/// Reallocates to fit the elements exactly, capacity() becomes size().
+			void shrink_to_fit( )
+			{
+				if( capacity() > size() )
+					reallocate( size() );
+			}
+
+			/// Destroys all the elements, the capacity is kept.
+			void clear( )
+			{
+				destroy( m_first, m_last );
+				m_last = m_first;
+			}
+
+			/// Checks if the vector is empty.
+			bool empty( ) const
+			{ return m_first == m_last; }
+
+			/// Adds value to the front of the vector. Moves every element, O(size()).
+			void push_front( const T & value )
+			{
+				insert( begin(), value );
+			}
+
+			/// Adds value to the end of the vector.
+			void push_back( const T & value )
+			{
+				emplace_back( value );
+			}
+
+			void push_back( T && value )
+			{
+				emplace_back( std::move( value ) );
+			}
+
+			/// Constructs an element from args at the end of the vector and returns it.
+			template< typename... Args >
+			T & emplace_back( Args &&... args )
+			{
+				if( m_last != m_end )
+					alloc_traits::construct( m_alloc, m_last, std::forward< Args >( args )... );
+				else
+					grow_and_emplace( std::forward< Args >( args )... );
+
+				return *m_last++;
+			}
+
+			/// Removes the object at the end of the vector.
+			void pop_back( )
+			{
+				if( empty() )
+					return;
+
+				alloc_traits::destroy( m_alloc, --m_last );
+			}
+
+			/// Removes the object at the front of the vector. Moves every element, O(size()).
+			void pop_front( )
+			{
+				if( empty() )
+					return;
+
+				erase( begin() );
+			}
+
+			/// Returns the object at the end of the vector.
+			const T & back( ) const
+			{ return m_last[-1]; }
+
+			/// Returns the object at the beginning of the vector.
+			const T & front( ) const
+			{ return *m_first; }
+
+			/// Resizes to count elements, appending value-initialized ones or destroying the last ones.
+			void resize( size_type count )
+			{
+				reserve( count );
+				while( size() < count )
+					emplace_back();
+				erase( begin() + count, end() );
+			}
+
+			/// Replaces the content of the vector with copies of value.
+			void assign( const T & value )
+			{
+				std::fill( m_first, m_last, value );
+			}
+
+			/// Replaces the contents with the elements of [first; last).
+			template< typename InItr >
+			void assign( InItr first, InItr last )
+			{
+				clear();
+				insert( end(), first, last );
+			}
+
+			/// Replaces the contents with the elements of ilist.
+			void assign( std::initializer_list< T > ilist )
+			{
+				assign( ilist.begin(), ilist.end() );
+			}
+
+			/// Return the object at the index position, like std::vector it doesn't check pos.
+			T & operator[]( size_type pos )
+			{ return m_first[pos]; }
+
+			const T & operator[]( size_type pos ) const
+			{ return m_first[pos]; }
+
+			/// Returns the object at the index pos in the vector.
+			T & at( size_type pos )
+			{
+				if( not ( pos < size() ) )
+					throw std::out_of_range("error in at(): out of range");
+
+				return m_first[pos];
+			}
+
+			const T & at( size_type pos ) const
+			{
+				if( not ( pos < size() ) )
+					throw std::out_of_range("error in at(): out of range");
+
+				return m_first[pos];
+			}
+
+			//=== Operators overload
+			/// Replaces the contents with a copy of other.
+			vector& operator=( const vector& other )
+			{
+				if( this != &other )
+				{
+					vector copy( other );
+					swap( copy );
+				}
+
+				return *this;
+			}
+
+			/// Takes the storage of other and leaves it empty. When the allocators differ and other's doesn't
+			/// propagate, the storage can't change hands and the elements are moved one by one instead.
+			vector& operator=( vector&& other ) noexcept( alloc_traits::propagate_on_container_move_assignment::value
+				or alloc_traits::is_always_equal::value )
+			{
+				if( this != &other )
+					move_assign( other, typename alloc_traits::propagate_on_container_move_assignment() );
+
+				return *this;
+			}
+
+			/// Replaces the contents with the elements of ilist.
+			vector& operator=( std::initializer_list<T> ilist )
+			{
+				assign( ilist );
+
+				return *this;
+			}
+
+			/// Checks if the contents of the vectors are equal.
+			bool operator==( const vector& rhs ) const
+			{
+				return size() == rhs.size() and std::equal( begin(), end(), rhs.begin() );
+			}
+
+			/// Checks if the contents of the vectors are different.
+			bool operator!=( const vector& rhs ) const
+			{
+				return not( *this == rhs );
+			}
+
+			/// Exchanges the contents with other's, iterators stay valid and follow their elements.
+			void swap( vector & other ) noexcept
+			{
+				std::swap( m_alloc, other.m_alloc );
+				std::swap( m_first, other.m_first );
+				std::swap( m_last, other.m_last );
+				std::swap( m_end, other.m_end );
+			}
+
+			/// Adds value before pos. Returns an iterator to the inserted element.
+			iterator insert( const_iterator pos, const T & value )
+			{
+				size_type index = pos - m_first;
+				emplace_back( value );
+				std::rotate( m_first + index, m_last - 1, m_last );
+
+				return m_first + index;
+			}
+
+			/// Adds the elements of [first; last) before pos. Returns an iterator to the first inserted element.
+			template< typename InItr >
+			iterator insert( const_iterator pos, InItr first, InItr last )
+			{
+				size_type index = pos - m_first;
+				size_type old_size = size();
+
+				if( std::is_base_of< std::forward_iterator_tag, typename std::iterator_traits< InItr >::iterator_category >::value )
+					reserve( grown_capacity( std::distance( first, last ) ) );
+				for( ; first != last ; ++first )
+					emplace_back( *first );
+				std::rotate( m_first + index, m_first + old_size, m_last );
+
+				return m_first + index;
+			}
+
+			/// Adds the elements of ilist before pos. Returns an iterator to the first inserted element.
+			iterator insert( const_iterator pos, std::initializer_list< T > ilist )
+			{
+				return insert( pos, ilist.begin(), ilist.end() );
+			}
+
+			/// Removes the object at position pos. Returns an iterator to the element that follows pos before the call.
+			iterator erase( const_iterator pos )
+			{
+				return erase( pos, pos + 1 );
+			}
+
+			/// Removes elements in the range [first; last).
+			iterator erase( const_iterator ifirst, const_iterator ilast )
+			{
+				T * first = m_first + ( ifirst - m_first );
+				T * last = m_first + ( ilast - m_first );
+
+				if( first != last )
+				{
+					T * kept = std::move( last, m_last, first );
+					destroy( kept, m_last );
+					m_last = kept;
+				}
+
+				return first;
+			}
+
+			/// Removes every element equal to value. Returns the number of removed elements.
+			size_type remove( const T & value )
+			{
+				return remove_if( [&value]( const T & e ){ return e == value; } );
+			}
+
+			/// Removes every element for which p returns true. Returns the number of removed elements.
+			template< typename UnaryPredicate >
+			size_type remove_if( UnaryPredicate p )
+			{
+				size_type old_size = size();
+				erase( std::remove_if( begin(), end(), p ), end() );
+
+				return old_size - size();
+			}
+
+			/// Removes consecutive duplicates. Returns the number of removed elements.
+			size_type unique( )
+			{
+				return unique( []( const T & a, const T & b ){ return a == b; } );
+			}
+
+			/// Removes the elements p finds equal to the one before them. Returns the number of removed elements.
+			template< typename BinaryPredicate >
+			size_type unique( BinaryPredicate p )
+			{
+				size_type old_size = size();
+				erase( std::unique( begin(), end(), p ), end() );
+
+				return old_size - size();
+			}
+
+			/// Sorts the elements in ascending order. Stable, like sc::list::sort().
+			void sort( )
+			{
+				std::stable_sort( begin(), end() );
+			}
+
+			/// Sorts the elements by comp, a strict weak ordering. Stable, like sc::list::sort().
+			template< typename Compare >
+			void sort( Compare comp )
+			{
+				std::stable_sort( begin(), end(), comp );
+			}
+
+			friend std::ostream& operator<<(std::ostream& os, const vector& v)
+			{
+				os << "[ ";
+				for( const T & value : v )
+					os << value << " ";
+				os << "]";
+
+				return os;
+			}
+
+		private:
+			/// Capacity after growing to hold extra more elements: at least double the current one.
+			size_type grown_capacity( size_type extra ) const
+			{
+				size_type needed = size() + extra;
+				if( needed <= capacity() )
+					return capacity();
+
+				return std::max( { needed, 2 * capacity(), min_capacity } );
+			}
+
+			/// Constructs the element after the last one in a larger storage, then relocates the others.
+			/// The element is built first because args may refer to an element of the vector.
+			template< typename... Args >
+			void grow_and_emplace( Args &&... args )
+			{
+				size_type new_cap = grown_capacity( 1 );
+				T * fresh = alloc_traits::allocate( m_alloc, new_cap );
+
+				try {
+					alloc_traits::construct( m_alloc, fresh + size(), std::forward< Args >( args )... );
+				} catch( ... ) {
+					alloc_traits::deallocate( m_alloc, fresh, new_cap );
+					throw;
+				}
+
+				try {
+					relocate( fresh, std::is_trivially_copyable< T >() );
+				} catch( ... ) {
+					alloc_traits::destroy( m_alloc, fresh + size() );
+					alloc_traits::deallocate( m_alloc, fresh, new_cap );
+					throw;
+				}
+
+				adopt( fresh, new_cap );
+			}
+
+			/// Moves the elements to a storage of new_cap elements, new_cap >= size().
+			void reallocate( size_type new_cap )
+			{
+				T * fresh = new_cap > 0 ? alloc_traits::allocate( m_alloc, new_cap ) : nullptr;
+
+				try {
+					relocate( fresh, std::is_trivially_copyable< T >() );
+				} catch( ... ) {
+					alloc_traits::deallocate( m_alloc, fresh, new_cap );
+					throw;
+				}
+
+				adopt( fresh, new_cap );
+			}
+
+			/// Relocates the elements to fresh, bytewise.
+			void relocate( T * fresh, std::true_type )
+			{
+				if( not empty() )
+					std::memcpy( static_cast< void * >( fresh ), static_cast< const void * >( m_first ), size() * sizeof( T ) );
+			}
+
+			/// Moves, or copies when moving could throw, the elements to fresh, then destroys the old ones.
+			/// If a copy throws, the elements built in fresh are destroyed and the old ones are untouched.
+			void relocate( T * fresh, std::false_type )
+			{
+				size_type built = 0;
+				try {
+					for( ; built < size() ; built++ )
+						alloc_traits::construct( m_alloc, fresh + built, std::move_if_noexcept( m_first[built] ) );
+				} catch( ... ) {
+					destroy( fresh, fresh + built );
+					throw;
+				}
+
+				destroy( m_first, m_last );
+			}
+
+			/// Frees the old storage and takes fresh, which holds the relocated elements.
+			void adopt( T * fresh, size_type new_cap )
+			{
+				size_type count = size();
+				if( m_first != nullptr )
+					alloc_traits::deallocate( m_alloc, m_first, capacity() );
+
+				m_first = fresh;
+				m_last = fresh + count;
+				m_end = fresh + new_cap;
+			}
+
+			/// Destroys the elements in [first; last).
+			void destroy( T * first, T * last )
+			{
+				if( not std::is_trivially_destructible< T >::value )
+				{
+					for( ; first != last ; ++first )
+						alloc_traits::destroy( m_alloc, first );
+				}
+			}
+
+			/// Move assignment when the allocator propagates: the storage follows it.
+			void move_assign( vector & other, std::true_type )
+			{
+				release();
+				m_alloc = std::move( other.m_alloc );
+				take_storage( other );
+			}
+
+			/// Move assignment when the allocator stays: the storage only changes hands between equal allocators.
+			void move_assign( vector & other, std::false_type )
+			{
+				if( m_alloc == other.m_alloc )
+				{
+					release();
+					take_storage( other );
+				}
+				else
+				{
+					assign( std::make_move_iterator( other.begin() ), std::make_move_iterator( other.end() ) );
+					other.clear();
+				}
+			}
+
+			/// Takes the storage of other and leaves it empty. This vector must hold none.
+			void take_storage( vector & other )
+			{
+				m_first = other.m_first;
+				m_last = other.m_last;
+				m_end = other.m_end;
+				other.m_first = other.m_last = other.m_end = nullptr;
+			}
+
+			/// Destroys the elements and frees the storage.
+			void release( )
+			{
+				destroy( m_first, m_last );
+				if( m_first != nullptr )
+					alloc_traits::deallocate( m_alloc, m_first, capacity() );
+				m_first = m_last = m_end = nullptr;
+			}
+	}; // class vector
+
+	/// Erases the elements of seq for which pred returns true. Returns the number of erased elements.
+	template< typename T, typename Allocator, typename Pred >
+	size_t erase_if( vector< T, Allocator > & seq, Pred pred )
+	{
+		return seq.remove_if( pred );
+	}
+
+} // namespace sc
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef VIEWS_H
+#define VIEWS_H
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+/*! \namespace sc
+    \brief namespace to differ from std
+*/
+namespace sc{
+
+
+	/*! \class chunk_view
+    	\brief lazy view of a range as consecutive subranges of n elements, the last one may be shorter.
+
+    	Each chunk is a std::ranges::subrange over the underlying iterators, nothing is copied.
+	*/
+	template< std::ranges::view V >
+		requires std::ranges::forward_range< V >
+	class chunk_view : public std::ranges::view_interface< chunk_view< V > >{
+		private:
+			//=== Alias
+			typedef std::ranges::iterator_t< V > base_iterator; //!< Iterator of the underlying range.
+			typedef std::ranges::sentinel_t< V > base_sentinel; //!< End of the underlying range.
+			typedef std::ranges::range_difference_t< V > difference_type; //!< Type of the chunk size.
+
+			//=== Attributes
+			V m_base; //!< Underlying range.
+			difference_type m_count; //!< Elements per chunk.
+
+		public:
+			class my_iterator;
+
+			//=== Constructors
+			chunk_view( ) = default;
+
+			/// View of base in chunks of count elements, count must be positive: no chunk would ever end otherwise.
+			constexpr chunk_view( V base, difference_type count )
+				: m_base( std::move( base ) ), m_count{count}
+			{
+				if( count <= 0 )
+					throw std::invalid_argument("error in chunk_view(): count must be positive");
+			}
+
+			//=== Iterators
+			/// Returns an iterator pointing to the first chunk.
+			constexpr my_iterator begin()
+			{ return my_iterator( std::ranges::begin( m_base ), std::ranges::end( m_base ), m_count ); }
+
+			/// Returns the sentinel compared equal to an iterator past the last chunk.
+			constexpr std::default_sentinel_t end()
+			{ return std::default_sentinel; }
+
+		/*! \class my_iterator
+
+			Forward iterator over the chunks, it keeps the bounds of the current one.
+		*/
+		class my_iterator{
+			private:
+				base_iterator m_first; //!< First element of the chunk.
+				base_iterator m_last; //!< Element after the chunk.
+				base_sentinel m_end; //!< End of the underlying range.
+				std::ranges::range_difference_t< V > m_count; //!< Elements per chunk.
+				typedef my_iterator iterator;
+
+			public:
+				//=== Alias
+				typedef std::forward_iterator_tag iterator_concept; //!< Chunks can be walked several times.
+				typedef std::forward_iterator_tag iterator_category; //!< Chunks can be walked several times.
+				typedef std::ranges::subrange< base_iterator > value_type; //!< A chunk.
+				typedef std::ranges::range_difference_t< V > difference_type; //!< Type of the distance between iterators.
+
+				//=== Constructor
+				my_iterator( ) = default;
+
+				constexpr my_iterator( base_iterator first, base_sentinel end, difference_type count )
+					: m_first( first ), m_last( std::ranges::next( first, count, end ) ), m_end( end ), m_count{count}
+				{/*empty*/}
+
+				//=== Operators
+				constexpr value_type operator*() const
+				{ return value_type( m_first, m_last ); }
+
+				constexpr iterator & operator++(void)
+				{
+					m_first = m_last;
+					m_last = std::ranges::next( m_first, m_count, m_end );
+					return *this;
+				}
+
+				constexpr iterator operator++(int)
+				{
+					iterator temp( *this );
+					++*this;
+					return temp;
+				}
+
+				constexpr bool operator==( const iterator& it2) const
+				{ return m_first == it2.m_first; }
+
+				constexpr bool operator==( std::default_sentinel_t ) const
+				{ return m_first == m_end; }
+
+		}; // class my_iterator
+
+	}; // class chunk_view
+
+	template< typename R >
+	chunk_view( R &&, std::ranges::range_difference_t< R > ) -> chunk_view< std::views::all_t< R > >;
+
+
+	/*! \namespace views
+		\brief lazy adaptors for sc containers, composable with | like std::views.
+
+		filter, transform and take are the standard ones, they work on sc::list
+		because its iterators are standard bidirectional iterators. chunk is ours.
+	*/
+	namespace views{
+
+		using std::views::filter;
+		using std::views::transform;
+		using std::views::take;
+
+		/// Partial application of chunk, the right-hand side of range | sc::views::chunk( n ).
+		struct chunk_closure{
+			std::ptrdiff_t count; //!< Elements per chunk.
+
+			template< std::ranges::viewable_range R >
+			friend constexpr auto operator|( R && range, chunk_closure closure )
+			{ return chunk_view( std::views::all( std::forward< R >( range ) ), closure.count ); }
+		};
+
+		/// Makes chunk_views, chunk( range, n ) or range | chunk( n ).
+		struct chunk_fn{
+			template< std::ranges::viewable_range R >
+			constexpr auto operator()( R && range, std::ptrdiff_t count ) const
+			{ return chunk_view( std::views::all( std::forward< R >( range ) ), count ); }
+
+			constexpr chunk_closure operator()( std::ptrdiff_t count ) const
+			{ return chunk_closure{ count }; }
+		};
+
+		inline constexpr chunk_fn chunk{}; //!< Splits a range into subranges of n elements.
+
+	} // namespace views
+
+} // namespace sc
+
+#endif
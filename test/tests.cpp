@@ -1,6 +1,36 @@
 #include <iostream>  // cout, endl
+#include <array>     // std::array
+#include <cstdint>   // std::uintptr_t
+#include <string>    // std::string
+#include <algorithm> // std::ranges::find
 #include <cassert>   // assert()
+#include <thread>    // std::thread
+#include <atomic>    // std::atomic
+#include <sstream>   // std::istringstream
+#include <random>    // std::mt19937
+#include <memory>    // std::shared_ptr
+#include <map>       // std::map
+#include <iterator>  // std::istream_iterator
+#include <cstdlib>   // std::strtol
+#include <unistd.h>  // pipe(), write(), close()
 #include "list.h"
+#include "snapshot_list.h"
+#include "hashed_list.h"
+#include "lru_cache.h"
+#include "sorted_list.h"
+#include "static_list.h"
+#include "views.h"
+#include "channel.h"
+#include "thread_caching_allocator.h"
+#include "external_sort.h"
+#include "vector.h"
+#include "adaptive_list.h"
+#include "forward_list.h"
+#include "list_format.h"
+#include "perf_scope.h"
+#include "list_pool.h"
+#include "compressed_list.h"
+#include "node_reclaimer.h"
 
 template < typename T = int >
 sc::list<T> createVec( const sc::list<T> & _v )
@@ -9,6 +39,286 @@ sc::list<T> createVec( const sc::list<T> & _v )
     return _v;
 }
 
+// Builds and edits an sc::list during constant evaluation, returns the sum of what is left.
+constexpr int constexprListSum( )
+{
+    sc::list<int> seq{ 1, 2, 3, 4 };
+    seq.push_front( 0 );
+    seq.push_back( 5 );
+    seq.pop_back();
+    seq.erase( seq.begin() + 1 );
+    seq.insert( seq.end(), 10 );
+    seq.reserve( 8 );
+
+    sc::list<int> copy( seq );
+    if ( copy != seq )
+        return -1;
+
+    auto sum{0};
+    for ( auto it = copy.begin() ; it != copy.end() ; ++it )
+        sum += *it;
+    copy.clear();
+
+    return sum + static_cast<int>( copy.size() );
+}
+
+// Pushes [first, last) into ch, closes it when it is the last of the producers still running.
+sc::detached_task produce( sc::channel<int> & ch, int first, int last, std::atomic<int> & running )
+{
+    for ( auto i = first ; i < last ; ++i )
+        co_await ch.push( i );
+    if ( --running == 0 )
+        ch.close();
+}
+
+// Pops from ch one value at a time until it is closed and drained.
+sc::detached_task consume( sc::channel<int> & ch, std::atomic<long> & sum, std::atomic<int> & count )
+{
+    while ( auto value = co_await ch.pop() )
+    {
+        sum += *value;
+        count++;
+    }
+}
+
+// Pops from ch in batches of at most limit values until it is closed and drained.
+sc::detached_task consume_many( sc::channel<int> & ch, size_t limit, sc::list<int> & out, size_t & batches )
+{
+    while ( true )
+    {
+        auto batch = co_await ch.pop_many( limit );
+        if ( batch.empty() )
+            break;
+        assert( batch.size() <= limit );
+        batches++;
+        out.splice( out.end(), batch );
+    }
+}
+
+// Waits on ch until it is closed, then records id in the order the waiters were resumed.
+sc::detached_task await_close( sc::channel<int> & ch, int id, std::vector<int> & order )
+{
+    co_await ch.pop();
+    order.push_back( id );
+}
+
+// The same code against any sc container: fills it, edits it in the middle, returns the sum.
+template < typename Seq >
+long containerWorkload( )
+{
+    Seq seq{ 1, 2, 3 };
+    for ( auto i{4} ; i <= 10 ; ++i )
+        seq.push_back( i );
+    seq.push_front( 0 );
+    seq.insert( seq.begin() + 2, { 100, 200 } );
+    seq.erase( seq.begin() + 2, seq.begin() + 4 );
+    seq.remove_if( []( int x ){ return x % 5 == 0; } );
+    seq.at( 0 ) = seq[1] + seq.front() + seq.back();
+
+    long sum = 0;
+    for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+        sum += *it;
+    return sum + static_cast<long>( seq.size() );
+}
+
+// Counts its copies and moves; its copy throws once armed, its move may be noexcept.
+template < bool NothrowMove >
+struct Tracked
+{
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static inline int copies_left = -1;
+    int value;
+
+    Tracked( int v = 0 ) : value{ v } {}
+    Tracked( const Tracked & other ) : value{ other.value }
+    {
+        if ( copies_left == 0 )
+            throw std::runtime_error( "copy" );
+        if ( copies_left > 0 )
+            copies_left--;
+        copies++;
+    }
+    Tracked( Tracked && other ) noexcept( NothrowMove ) : value{ other.value } { moves++; }
+    Tracked & operator=( const Tracked & ) = default;
+    Tracked & operator=( Tracked && ) = default;
+};
+
+// Counts the live instances; no default constructor, so only lists that never need one can hold it.
+struct Counted
+{
+    static inline int alive = 0;
+    int value;
+
+    explicit Counted( int v ) : value{ v } { alive++; }
+    Counted( const Counted & other ) : value{ other.value } { alive++; }
+    Counted & operator=( const Counted & ) = default;
+    ~Counted() { alive--; }
+    bool operator==( const Counted & other ) const { return value == other.value; }
+};
+
+// Stateful allocator: instances with different ids don't share memory, and each block must go back
+// to the id it came from. It propagates on move assignment only when Propagate is set.
+template < typename T, bool Propagate = false >
+struct TaggedAllocator
+{
+    typedef T value_type;
+    typedef std::bool_constant< Propagate > propagate_on_container_move_assignment;
+    typedef std::false_type is_always_equal;
+    template < typename U >
+    struct rebind { typedef TaggedAllocator< U, Propagate > other; };
+
+    static inline std::map< void *, int > owners;
+    int id;
+
+    explicit TaggedAllocator( int i ) : id{ i } {}
+    template < typename U >
+    TaggedAllocator( const TaggedAllocator<U, Propagate> & other ) : id{ other.id } {}
+
+    T * allocate( size_t n )
+    {
+        T * p = std::allocator<T>().allocate( n );
+        TaggedAllocator<char>::owners[p] = id;
+        return p;
+    }
+    void deallocate( T * p, size_t n )
+    {
+        auto owner = TaggedAllocator<char>::owners.find( p );
+        assert( owner != TaggedAllocator<char>::owners.end() and owner->second == id );
+        TaggedAllocator<char>::owners.erase( owner );
+        std::allocator<T>().deallocate( p, n );
+    }
+    template < typename U >
+    bool operator==( const TaggedAllocator<U, Propagate> & other ) const { return id == other.id; }
+};
+
+// Move assigns between containers of the same and of different allocators, every block must go
+// back to the allocator it came from.
+template < typename Container >
+void checkMoveAssignAllocators( bool propagate )
+{
+    typedef typename Container::allocator_type allocator;
+    {
+        Container left( allocator( 1 ) );
+        Container right( allocator( 2 ) );
+        for ( auto i{0} ; i < 3 ; ++i )
+            left.push_back( std::to_string( i ) );
+        for ( auto i{0} ; i < 5 ; ++i )
+            right.push_back( std::string( 32, 'a' + i ) );
+
+        left = std::move( right );
+        assert( right.empty() and left.size() == 5 and left.back() == std::string( 32, 'e' ) );
+        assert( ( left.get_allocator() == allocator( 2 ) ) == propagate );
+
+        Container same( left.get_allocator() );
+        same.push_back( "x" );
+        same = std::move( left );
+        assert( left.empty() and same.size() == 5 and same.front() == std::string( 32, 'a' ) );
+
+        left.push_back( "y" );
+        right.push_back( "z" );
+    }
+    assert( TaggedAllocator<char>::owners.empty() );
+}
+
+// Removes elements every way a list can, checks each removal destroys them right away.
+template < typename Layout >
+void checkRemovedDestroyed( )
+{
+    {
+        sc::list< Counted, std::allocator< Counted >, Layout > seq;
+        seq.reserve( 16 );
+        assert( Counted::alive == 0 and seq.capacity() == 16 );
+        for ( auto i{0} ; i < 10 ; ++i )
+            seq.push_back( Counted( i / 2 ) );
+        assert( Counted::alive == 10 );
+
+        seq.pop_back();
+        seq.pop_front();
+        assert( Counted::alive == 8 );
+        seq.erase( seq.begin() );
+        seq.erase( seq.begin(), seq.begin() + 2 );
+        assert( Counted::alive == 5 );
+        assert( seq.unique() == 2 and Counted::alive == 3 );
+        assert( seq.remove_if( []( const Counted & c ){ return c.value == 3; } ) == 1 and Counted::alive == 2 );
+        seq = { Counted( 7 ) };
+        assert( Counted::alive == 1 and seq.capacity() == 16 );
+        seq.push_back( Counted( 8 ) );
+        assert( Counted::alive == 2 );
+        seq.clear();
+        assert( Counted::alive == 0 );
+        seq.push_back( Counted( 9 ) );
+    }
+    assert( Counted::alive == 0 );
+
+    auto shared = std::make_shared<int>( 1 );
+    sc::list< std::shared_ptr<int>, std::allocator< std::shared_ptr<int> >, Layout > owners{ shared, shared, shared };
+    owners.pop_back();
+    owners.erase( owners.begin() );
+    assert( shared.use_count() == 2 );
+    owners.remove_if( []( const std::shared_ptr<int> & p ){ return p != nullptr; } );
+    assert( shared.use_count() == 1 and owners.capacity() == 3 );
+}
+
+// Pushes count values into ch, each one built in place and moved in, then closes it.
+template < typename Item, typename Make >
+sc::detached_task send_moved( sc::channel< Item > & ch, int count, Make make )
+{
+    for ( auto i{0} ; i < count ; ++i )
+        co_await ch.push( make( i ) );
+    ch.close();
+}
+
+// Pops from ch, one at a time or in batches of 3, until it is closed; adds value( item ) to sum.
+template < typename Item, typename Value >
+sc::detached_task receive_moved( sc::channel< Item > & ch, bool batches, long & sum, Value value )
+{
+    if ( batches )
+    {
+        while ( true )
+        {
+            auto batch = co_await ch.pop_many( 3 );
+            if ( batch.empty() )
+                break;
+            for ( auto & item : batch )
+                sum += value( item );
+        }
+    }
+    else
+        while ( auto item = co_await ch.pop() )
+            sum += value( *item );
+}
+
+// Runs the usual edits on a list of the given node layout, returns its contents as a string.
+template < typename Layout >
+std::string layoutWorkload( )
+{
+    sc::list< std::string, std::allocator< std::string >, Layout > seq{ "d", "b" };
+    seq.push_back( "e" );
+    seq.push_front( "a" );
+    seq.insert( seq.begin() + 2, "c" );
+    seq.sort();
+    seq.reverse();
+    seq.erase( seq.begin() );
+    auto copy( seq );
+    copy.splice( copy.end(), seq );
+    seq.push_back( "z" );
+    seq.clear_async();
+    copy.remove( "c" );
+
+    std::string out;
+    for ( auto it = copy.begin() ; it != copy.end() ; ++it )
+        out += *it;
+    return out + std::to_string( copy.size() );
+}
+
+// Clears its list asynchronously when destroyed, which for a static may be after the reclaimer is gone.
+struct ClearedAtExit
+{
+    sc::list<int> seq{ 1, 2, 3 };
+    ~ClearedAtExit() { seq.clear_async(); }
+};
+
 // The vector/iterator driver.
 int main( void )
 {
@@ -65,6 +375,11 @@ int main( void )
         for ( auto it = vec3.begin() ; it != vec3.end() ; ++it, ++it2 )
             assert( *it == *it2 );
 
+        // A literal 0 is an offset, not a null node pointer.
+        assert( seq.end() - 0 == seq.end() and seq.begin() + 0 == seq.begin() );
+        const auto & view = seq;
+        assert( view.end() - 0 == view.end() );
+
         std::cout << ">>> Passed!\n\n";
     }
 
@@ -520,5 +835,1623 @@ int main( void )
         std::cout << ">>> Passed!\n\n";
     }
 
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": remove(), remove_if(), erase_if() and unique().\n";
+
+        sc::list<int> seq { 1, 2, 3, 2, 5, 2 };
+
+        assert( seq.remove( 2 ) == 3 );
+        assert( seq == ( sc::list<int>{ 1, 3, 5 } ) );
+        assert( seq.size() == 3 );
+        assert( seq.remove( 4 ) == 0 );
+
+        // Removing with a reference to one of the removed elements.
+        seq = { 7, 1, 7, 7 };
+        assert( seq.remove( seq.front() ) == 3 );
+        assert( seq == ( sc::list<int>{ 1 } ) );
+
+        seq = { 1, 2, 3, 4, 5, 6 };
+        assert( seq.remove_if( []( int e ){ return e % 2 == 0; } ) == 3 );
+        assert( seq == ( sc::list<int>{ 1, 3, 5 } ) );
+        assert( sc::erase_if( seq, []( int e ){ return e > 1; } ) == 2 );
+        assert( seq == ( sc::list<int>{ 1 } ) );
+        assert( seq.back() == 1 );
+
+        seq = { 1, 1, 2, 2, 2, 3, 1, 1 };
+        assert( seq.unique() == 4 );
+        assert( seq == ( sc::list<int>{ 1, 2, 3, 1 } ) );
+        assert( seq.size() == 4 );
+
+        // Drops the elements closer than 3 to the last kept one.
+        seq = { 1, 2, 3, 7, 8, 10 };
+        assert( seq.unique( []( int kept, int e ){ return e - kept < 3; } ) == 3 );
+        assert( seq == ( sc::list<int>{ 1, 7, 10 } ) );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": clear_some() and clear_async().\n";
+
+        // Built before the reclaimer, so destroyed after it at exit: its nodes are freed on the spot.
+        static ClearedAtExit late;
+
+        sc::list<int> seq { 1, 2, 3, 4, 5 };
+
+        // The list is emptied at once, the nodes are freed along the calls.
+        assert( seq.clear_some( 2 ) == false );
+        assert( seq.empty() == true );
+        assert( seq.begin() == seq.end() );
+
+        seq.push_back( 6 );
+        assert( seq.clear_some( 2 ) == false );
+        assert( seq.clear_some( 2 ) == true );
+        assert( seq.clear_some( 2 ) == true );
+        assert( seq.empty() == true );
+
+        // Left over nodes are freed by the destructor.
+        {
+            sc::list<int> seq2 { 1, 2, 3, 4, 5 };
+            seq2.clear_some( 1 );
+            seq2.push_back( 1 );
+            assert( seq2.size() == 1 );
+        }
+
+        seq = { 1, 2, 3, 4, 5 };
+        seq.clear_async();
+        assert( seq.empty() == true );
+        seq.push_back( 7 );
+        assert( seq == ( sc::list<int>{ 7 } ) );
+        sc::node_reclaimer::instance().wait_idle();
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": reserve(), capacity() and shrink_to_fit().\n";
+
+        sc::list<int> seq;
+        assert( seq.capacity() == 0 );
+
+        seq.reserve( 4 );
+        assert( seq.capacity() == 4 );
+        assert( seq.size() == 0 );
+
+        // Growing within the capacity takes the spare nodes.
+        for ( auto i{1} ; i <= 4 ; ++i )
+            seq.push_back( i );
+        assert( seq.capacity() == 4 );
+        seq.push_front( 0 );
+        assert( seq.capacity() == 5 );
+        assert( seq == ( sc::list<int>{ 0, 1, 2, 3, 4 } ) );
+
+        // Shrinking keeps the nodes as spare capacity.
+        seq.pop_front();
+        seq.pop_back();
+        seq.erase( seq.begin() );
+        assert( seq == ( sc::list<int>{ 2, 3 } ) );
+        assert( seq.capacity() == 5 );
+        seq.remove( 3 );
+        assert( seq.capacity() == 5 );
+
+        seq = { 1, 2, 3, 4, 5, 6 };
+        assert( seq.capacity() == 6 );
+        seq = { 1, 2 };
+        assert( seq == ( sc::list<int>{ 1, 2 } ) );
+        assert( seq.back() == 2 );
+        assert( seq.capacity() == 6 );
+
+        seq.insert( seq.end(), { 3, 4 } );
+        assert( seq.capacity() == 6 );
+        assert( seq == ( sc::list<int>{ 1, 2, 3, 4 } ) );
+
+        seq.shrink_to_fit();
+        assert( seq.capacity() == 4 );
+        seq.reserve( 2 );
+        assert( seq.capacity() == 4 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": iterator distance.\n";
+
+        sc::list<int> seq { 1, 2, 3, 4, 5 };
+
+        assert( seq.end() - seq.begin() == 5 );
+        assert( seq.begin() - seq.end() == -5 );
+        assert( ( seq.begin() + 3 ) - ( seq.begin() + 1 ) == 2 );
+        assert( ( seq.begin() + 1 ) - ( seq.begin() + 3 ) == -2 );
+        assert( seq.begin() - seq.begin() == 0 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+#ifdef SC_LIST_ORDER_LABELS
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": order-maintenance labels.\n";
+
+        sc::list<int> seq;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            seq.push_back( i );
+        // Always inserting at the same spot drains the label gaps quickly.
+        auto middle = seq.begin() + 500;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            seq.insert( middle, -i );
+        for ( auto i{0} ; i < 100 ; ++i )
+            seq.push_front( i );
+
+        auto previous = seq.begin();
+        for ( auto it = seq.begin() + 1 ; it != seq.end() ; ++it )
+        {
+            assert( previous < it );
+            assert( it > previous );
+            assert( not ( it < previous ) );
+            previous = it;
+        }
+        assert( seq.begin() < seq.end() );
+        assert( seq.begin() <= seq.begin() );
+        assert( seq.end() - seq.begin() == 2100 );
+        assert( middle - seq.begin() == 1600 );
+        assert( seq.begin() - middle == -1600 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+#endif
+
+#ifdef SC_LIST_PROFILE
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": traversal profiler.\n";
+
+        auto & profiler = sc::traversal_profiler::instance();
+        profiler.report_at_exit( nullptr );
+        profiler.reset();
+
+        sc::list<int> seq;
+        for ( auto i{0} ; i < 200 ; ++i )
+            seq.push_back( i );
+
+        // An accidental quadratic loop, then a constant time access.
+        auto sum{0};
+        for ( auto i{0u} ; i < seq.size() ; ++i )
+            sum += seq.at( i );
+        auto quadratic_line = __LINE__ - 1;
+        sum += seq[1];
+        assert( sum == 199 * 100 + 1 );
+
+        // Iterator arithmetic: a fixed offset costs the same at any size, one following the loop index doesn't.
+        for ( auto i{0} ; i < 4 ; ++i )
+            assert( *( seq.begin() + 150 ) == 150 );
+        auto iterated{0};
+        for ( auto i{0} ; i < 100 ; ++i )
+            iterated += *( seq.begin() + 2 * i );
+        auto indexed_line = __LINE__ - 1;
+        assert( iterated == 99 * 100 );
+
+        // Walks on other threads are merged into the same sites.
+        auto walk = [&seq]() { return seq.at( 100 ); };
+        auto walk_line = __LINE__ - 1;
+        std::thread other( [&]() { for ( auto i{0} ; i < 10 ; ++i ) walk(); } );
+        other.join();
+        walk();
+
+        auto sites = profiler.sites();
+        assert( sites.size() == 5 );
+        assert( sites[0].line == static_cast<unsigned>( quadratic_line ) );
+        assert( sites[0].calls == 200 and sites[0].hops == 199 * 100 and sites[0].linear );
+        assert( sites[1].line == static_cast<unsigned>( indexed_line ) );
+        assert( sites[1].hops == 99 * 100 and sites[1].sizes == 0 and sites[1].linear );
+        assert( sites[2].line == static_cast<unsigned>( walk_line ) );
+        assert( sites[2].calls == 11 and sites[2].hops == 1100 and sites[2].linear );
+        assert( sites[3].hops == 600 and sites[3].sizes == 0 and sites[3].min_hops == 150 and not sites[3].linear );
+        assert( sites[4].hops == 1 and not sites[4].linear );
+        assert( seq.traversal_hops() == 199 * 100 + 1 + 1100 );
+
+        std::ostringstream report;
+        profiler.report( report );
+        assert( report.str().find( "[O(n) walk]" ) != std::string::npos );
+
+        profiler.reset();
+        std::cout << ">>> Passed!\n\n";
+    }
+#endif
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": input iterators and append_from().\n";
+
+        // Single pass range constructor.
+        std::istringstream input( "1 2 3 4 5" );
+        sc::list<int> seq( std::istream_iterator<int>( input ), ( std::istream_iterator<int>() ) );
+        assert( seq == ( sc::list<int>{ 1, 2, 3, 4, 5 } ) );
+
+        // Batches smaller than the input.
+        std::istringstream more( "6 7 8 9 10 x 11" );
+        assert( seq.append_from( more, 2 ) == 5 );
+        assert( seq.size() == 10 );
+        assert( seq.back() == 10 );
+        assert( seq == ( sc::list<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } ) );
+
+        // Custom parser reading comma separated values.
+        std::istringstream csv( "4,5,6" );
+        sc::list<int> seq2;
+        auto read_csv = []( std::istream & in, int & value ){
+            if ( not ( in >> value ) )
+                return false;
+            if ( in.peek() == ',' )
+                in.get();
+            return true;
+        };
+        assert( seq2.append_from( csv, read_csv ) == 3 );
+        assert( seq2 == ( sc::list<int>{ 4, 5, 6 } ) );
+
+        // A batch size of 0 is refused, a throwing parser leaves the list as it was and recycles the nodes.
+        bool thrown = false;
+        std::istringstream again( "1 2 3" );
+        try {
+            seq2.append_from( again, 0 );
+        } catch ( std::invalid_argument & ) {
+            thrown = true;
+        }
+        assert( thrown and seq2.size() == 3 );
+        std::istringstream many( "7 8 9 10 11" );
+        auto picky = []( std::istream & in, int & value ){
+            if ( not ( in >> value ) )
+                return false;
+            if ( value == 10 )
+                throw std::runtime_error( "ten" );
+            return true;
+        };
+        thrown = false;
+        try {
+            seq2.append_from( many, picky, 2 );
+        } catch ( std::runtime_error & ) {
+            thrown = true;
+        }
+        assert( thrown and seq2 == ( sc::list<int>{ 4, 5, 6 } ) and seq2.capacity() == 7 );
+
+        // Same for a file descriptor with a bad token after a full batch.
+        int bad[2];
+        assert( pipe( bad ) == 0 );
+        std::string bad_text( "1 2 3 x 5" );
+        assert( write( bad[1], bad_text.data(), bad_text.size() ) == static_cast<ssize_t>( bad_text.size() ) );
+        close( bad[1] );
+        auto digits = []( const char * first, const char * last, int & value ){
+            if ( last - first != 1 or not std::isdigit( *first ) )
+                return false;
+            value = *first - '0';
+            return true;
+        };
+        thrown = false;
+        try {
+            seq2.append_from( bad[0], digits, 2 );
+        } catch ( std::invalid_argument & ) {
+            thrown = true;
+        }
+        close( bad[0] );
+        assert( thrown and seq2 == ( sc::list<int>{ 4, 5, 6 } ) and seq2.size() == 3 );
+
+        // File descriptor with tokens spread over several writes.
+        int fds[2];
+        assert( pipe( fds ) == 0 );
+        std::string text;
+        for ( auto i{0} ; i < 20000 ; ++i )
+            text += std::to_string( i ) + ( i % 7 ? " " : "\n" );
+        std::thread feeder( [&]() {
+            for ( size_t sent = 0 ; sent < text.size() ; sent += 1000 )
+                assert( write( fds[1], text.data() + sent, std::min< size_t >( 1000, text.size() - sent ) ) > 0 );
+            close( fds[1] );
+        } );
+        sc::list<int> seq3;
+        auto read_int = []( const char * first, const char * last, int & value ){
+            std::string token( first, last );
+            char * end;
+            value = std::strtol( token.c_str(), &end, 10 );
+            return *end == '\0';
+        };
+        assert( seq3.append_from( fds[0], read_int, 1000 ) == 20000 );
+        feeder.join();
+        close( fds[0] );
+        auto i{0};
+        for ( auto e : seq3 )
+            assert( e == i++ );
+        assert( seq3.size() == 20000 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": hashed_list.\n";
+
+        sc::hashed_list<int> seq { 1, 2, 3, 2, 4 };
+        assert( seq.size() == 4 );
+        assert( seq.contains( 3 ) );
+        assert( not seq.contains( 5 ) );
+        assert( *seq.find( 4 ) == 4 );
+        assert( seq.find( 5 ) == seq.end() );
+
+        auto inserted = seq.push_back( 5 );
+        assert( inserted.second and *inserted.first == 5 );
+        inserted = seq.push_front( 5 );
+        assert( not inserted.second and *inserted.first == 5 );
+
+        // Moved elements keep their node.
+        auto node = seq.find( 2 );
+        assert( seq.move_to_back( 2 ) );
+        assert( seq.find( 2 ) == node );
+        assert( seq.back() == 2 );
+        assert( not seq.move_to_back( 42 ) );
+
+        int expected[] = { 1, 3, 4, 5, 2 };
+        auto i{0};
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            assert( *it == expected[i++] );
+
+        assert( seq.erase( 3 ) == 1 );
+        assert( seq.erase( 3 ) == 0 );
+        assert( not seq.contains( 3 ) );
+        assert( seq.front() == 1 );
+        seq.pop_front();
+        assert( seq.front() == 4 );
+        assert( seq.size() == 3 );
+
+        // Many inserts and erases go through rehashes and probe runs.
+        sc::hashed_list<int> big;
+        for ( auto i{0} ; i < 10000 ; ++i )
+            big.push_back( i * 16 );
+        for ( auto i{0} ; i < 10000 ; i += 2 )
+            assert( big.erase( i * 16 ) == 1 );
+        assert( big.size() == 5000 );
+        for ( auto i{0} ; i < 10000 ; ++i )
+            assert( big.contains( i * 16 ) == ( i % 2 == 1 ) );
+        i = 1;
+        for ( auto it = big.begin() ; it != big.end() ; ++it, i += 2 )
+            assert( *it == i * 16 );
+
+        sc::hashed_list<std::string> names { "ana", "bia" };
+        assert( names.contains( "bia" ) );
+        names.clear();
+        assert( names.empty() and not names.contains( "bia" ) );
+
+        // Keyed by the first member, as an LRU index: values stay writable, lookups take the key.
+        typedef std::pair< const int, std::string > entry;
+        sc::hashed_list< entry, sc::first_key > lru;
+        lru.push_back( entry{ 7, "seven" } );
+        lru.push_back( entry{ 3, "three" } );
+        assert( not lru.push_back( entry{ 7, "other" } ).second );
+        assert( lru.find( 7 )->second == "seven" );
+        ( *lru.find( 7 ) ).second = "SEVEN";
+        assert( lru.move_to_back( 7 ) and lru.back().second == "SEVEN" );
+        assert( lru.front().first == 3 );
+        assert( lru.erase( 3 ) == 1 and lru.size() == 1 and not lru.contains( 3 ) );
+
+        // A const container only hands out read-only elements.
+        const auto & view = lru;
+        static_assert( std::is_same_v< decltype( *view.find( 7 ) ), const entry & > );
+        static_assert( std::is_same_v< decltype( *view.begin() ), const entry & > );
+        decltype( lru )::my_const_iterator first = lru.begin();
+        assert( first == view.find( 7 ) and first->second == "SEVEN" );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": splice().\n";
+
+        sc::list<int> seq { 1, 2, 3, 4, 5 };
+        sc::list<int> seq2 { 6, 7 };
+
+        // Moving a node within the same list.
+        auto it = seq.begin() + 1;
+        seq.splice( seq.end(), seq, it );
+        assert( seq == ( sc::list<int>{ 1, 3, 4, 5, 2 } ) );
+        assert( *it == 2 );
+        assert( seq.size() == 5 );
+
+        // Moving a node between lists.
+        seq.splice( seq.begin(), seq2, seq2.begin() + 1 );
+        assert( seq == ( sc::list<int>{ 7, 1, 3, 4, 5, 2 } ) );
+        assert( seq2 == ( sc::list<int>{ 6 } ) );
+
+        // Moving a whole list.
+        seq2.push_back( 8 );
+        seq.splice( seq.begin() + 1, seq2 );
+        assert( seq == ( sc::list<int>{ 7, 6, 8, 1, 3, 4, 5, 2 } ) );
+        assert( seq2.empty() );
+        assert( seq2.begin() == seq2.end() );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": lru_cache.\n";
+
+        sc::lru_cache<int, int> cache( 3 );
+        std::vector<int> evicted;
+        cache.on_evict( [&evicted]( const int & key, int & ){ evicted.push_back( key ); } );
+
+        cache.put( 1, 10 );
+        cache.put( 2, 20 );
+        cache.put( 3, 30 );
+        assert( *cache.get( 1 ) == 10 );
+
+        // 2 is the least recently used one now.
+        cache.put( 4, 40 );
+        assert( evicted.size() == 1 and evicted[0] == 2 );
+        assert( not cache.contains( 2 ) );
+        assert( cache.get( 2 ) == nullptr );
+        assert( cache.size() == 3 );
+
+        // Updating touches the entry.
+        cache.put( 3, 31 );
+        cache.put( 5, 50 );
+        assert( evicted.size() == 2 and evicted[1] == 1 );
+        assert( *cache.get( 3 ) == 31 );
+
+        assert( cache.stats().hits == 2 );
+        assert( cache.stats().misses == 1 );
+        assert( cache.stats().insertions == 5 );
+        assert( cache.stats().evictions == 2 );
+
+        assert( cache.erase( 3 ) );
+        assert( not cache.erase( 3 ) );
+        assert( cache.size() == 2 );
+        assert( evicted.size() == 2 );
+
+        // Byte budget.
+        struct value_size {
+            size_t operator()( const int &, const std::string & v ) const { return v.size(); }
+        };
+        sc::lru_cache<int, std::string, value_size> texts( 100, 10 );
+        texts.put( 1, "aaaa" );
+        texts.put( 2, "bbbb" );
+        assert( texts.bytes() == 8 );
+        texts.put( 3, "cccc" );
+        assert( texts.bytes() == 8 );
+        assert( not texts.contains( 1 ) );
+        texts.put( 4, "dddddddddddd" );
+        assert( texts.size() == 1 and texts.contains( 4 ) );
+
+        // Values need no default constructor, and evicted or erased ones are destroyed right away.
+        {
+            sc::lru_cache<int, Counted> counted( 2 );
+            for ( auto i{0} ; i < 10 ; ++i )
+                counted.put( i, Counted( i ) );
+            assert( Counted::alive == 2 );
+            assert( counted.get( 9 )->value == 9 and counted.get( 7 ) == nullptr );
+            counted.erase( 8 );
+            assert( Counted::alive == 1 );
+            counted.clear();
+            assert( Counted::alive == 0 and counted.empty() );
+        }
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": sorted_list.\n";
+
+        sc::sorted_list<int> seq { 5, 1, 4, 2, 3 };
+        assert( seq.size() == 5 );
+        auto i{1};
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            assert( *it == i++ );
+
+        // Inserting around the finger, in both directions.
+        assert( *seq.insert_sorted( 6 ) == 6 );
+        assert( *seq.insert_sorted( 0 ) == 0 );
+        assert( *seq.insert_sorted( 3 ) == 3 );
+        int expected[] = { 0, 1, 2, 3, 3, 4, 5, 6 };
+        i = 0;
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            assert( *it == expected[i++] );
+
+        assert( seq.lower_bound( 3 ) == seq.begin() + 3 );
+        assert( seq.upper_bound( 3 ) == seq.begin() + 5 );
+        assert( seq.lower_bound( 10 ) == seq.end() );
+        assert( seq.upper_bound( -1 ) == seq.begin() );
+        assert( seq.lower_bound( 0 ) == seq.begin() );
+
+        // Erasing the finger moves it to the next element.
+        seq.erase( seq.lower_bound( 4 ) );
+        assert( *seq.insert_sorted( 4 ) == 4 );
+        seq.pop_front();
+        seq.pop_back();
+        assert( seq.front() == 1 and seq.back() == 5 );
+        assert( seq.size() == 6 );
+
+        // Batch merge, with a custom order.
+        sc::sorted_list< int, std::greater<int> > desc;
+        desc.insert_sorted( 5 );
+        desc.insert_sorted( 1 );
+        std::vector<int> batch { 3, 7, 0, 5, 2 };
+        desc.insert_sorted( batch.begin(), batch.end() );
+        int expected2[] = { 7, 5, 5, 3, 2, 1, 0 };
+        i = 0;
+        for ( auto it = desc.begin() ; it != desc.end() ; ++it )
+            assert( *it == expected2[i++] );
+        assert( desc.size() == 7 );
+
+        // Nearly sorted stream.
+        sc::sorted_list<int> stream;
+        for ( auto i{0} ; i < 10000 ; ++i )
+            stream.insert_sorted( i % 10 == 0 ? i - 5 : i );
+        auto previous = stream.front();
+        for ( auto it = stream.begin() ; it != stream.end() ; ++it )
+        {
+            assert( previous <= *it );
+            previous = *it;
+        }
+
+        // Searches jumping around agree with std::lower_bound / std::upper_bound, and a far target
+        // costs a logarithmic number of comparisons.
+        size_t comparisons = 0;
+        auto counting = [&comparisons]( int a, int b ) { ++comparisons; return a < b; };
+        sc::sorted_list< int, decltype( counting ) > jumps( counting );
+        std::vector<int> values;
+        for ( auto i{0} ; i < 4096 ; ++i )
+            values.push_back( i / 3 );
+        jumps.insert_sorted( values.begin(), values.end() );
+        std::mt19937 rng( 7 );
+        for ( auto k{0} ; k < 500 ; ++k )
+        {
+            int target = static_cast<int>( rng() % 1400 ) - 10;
+            auto lower = std::lower_bound( values.begin(), values.end(), target ) - values.begin();
+            auto upper = std::upper_bound( values.begin(), values.end(), target ) - values.begin();
+            assert( jumps.lower_bound( target ) - jumps.begin() == lower );
+            assert( jumps.upper_bound( target ) - jumps.begin() == upper );
+        }
+        jumps.lower_bound( 0 );
+        comparisons = 0;
+        assert( *jumps.lower_bound( 1300 ) == 1300 );
+        assert( comparisons < 40 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": constexpr list and static_list.\n";
+
+        static_assert( constexprListSum() == 19, "sc::list must work in constant expressions" );
+
+        constexpr sc::static_list<int, 4> fixed{ 3, 1, 4 };
+        static_assert( fixed.size() == 3 and fixed.front() == 3 and fixed.back() == 4, "" );
+        static_assert( *( ++fixed.begin() ) == 1, "" );
+
+        sc::static_list<int, 4> seq( fixed );
+        assert( seq == fixed );
+        seq.pop_front();
+        seq.push_back( 5 );
+        seq.push_front( 9 );
+        assert( seq.full() );
+        bool threw = false;
+        try { seq.push_back( 6 ); }
+        catch ( const std::length_error & ) { threw = true; }
+        assert( threw );
+
+        const int expected[]{ 9, 1, 4, 5 };
+        auto i{0};
+        for ( auto it = seq.begin() ; it != seq.end() ; ++it )
+            assert( *it == expected[i++] );
+
+        // Erased slots are reused.
+        seq.erase( ++seq.begin() );
+        seq.insert( seq.begin(), 7 );
+        assert( seq.front() == 7 and seq.size() == 4 );
+        seq.clear();
+        assert( seq.empty() and seq != fixed );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": standard iterators and views.\n";
+
+        static_assert( std::bidirectional_iterator< sc::list<int>::iterator > );
+        static_assert( std::bidirectional_iterator< sc::list<int>::const_iterator > );
+        static_assert( std::ranges::bidirectional_range< const sc::list<int> > );
+        static_assert( std::is_same_v< std::iter_reference_t< sc::list<int>::const_iterator >, const int & > );
+
+        sc::list<int> seq{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+        // Dereferencing gives the element itself, not a copy.
+        *seq.begin() = 0;
+        assert( seq.front() == 0 and &*seq.begin() == &seq.front() );
+        const sc::list<int> & view = seq;
+        assert( &*( --view.end() ) == &seq.back() );
+        sc::list<int>::const_iterator converted = seq.begin();
+        assert( converted == view.begin() );
+        assert( std::ranges::find( seq, 7 ) == seq.begin() + 6 );
+
+        auto squares = seq | sc::views::filter( []( int x ){ return x % 2 == 0; } )
+                           | sc::views::transform( []( int x ){ return x * x; } )
+                           | sc::views::take( 3 );
+        const int expected[]{ 0, 4, 16 };
+        auto i{0};
+        for ( int x : squares )
+            assert( x == expected[i++] );
+        assert( i == 3 );
+
+        // Views are lazy: they see later changes to the list.
+        auto evens = seq | sc::views::filter( []( int x ){ return x % 2 == 0; } );
+        seq.push_back( 12 );
+        assert( std::ranges::distance( evens ) == 7 );
+
+        auto sizes_sum{0};
+        auto chunks{0};
+        for ( auto chunk : seq | sc::views::chunk( 4 ) )
+        {
+            sizes_sum += static_cast<int>( std::ranges::distance( chunk ) );
+            assert( *chunk.begin() == ( chunks == 0 ? 0 : chunks * 4 + 1 ) );
+            chunks++;
+        }
+        assert( chunks == 3 and sizes_sum == 11 );
+
+        // Chunks are subranges of the list, writes go through.
+        for ( auto chunk : sc::views::chunk( seq, 5 ) )
+            *chunk.begin() = -1;
+        assert( seq.front() == -1 and *( seq.begin() + 5 ) == -1 and seq.back() == -1 );
+
+        // A chunk size that isn't positive is refused instead of looping forever.
+        for ( auto count : { 0, -3 } )
+        {
+            bool thrown = false;
+            try {
+                auto none = seq | sc::views::chunk( count );
+                ( void ) none;
+            } catch ( std::invalid_argument & ) {
+                thrown = true;
+            }
+            assert( thrown );
+        }
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": channel.\n";
+
+        // Single threaded, unbounded: the producer runs to completion, then the consumer drains.
+        {
+            sc::manual_executor ex;
+            sc::channel<int> ch( ex );
+            std::atomic<int> running{1}, count{0};
+            std::atomic<long> sum{0};
+            sc::spawn( ex, consume( ch, sum, count ) );
+            sc::spawn( ex, produce( ch, 1, 101, running ) );
+            ex.run();
+            assert( count == 100 and sum == 5050 and ch.size() == 0 );
+        }
+
+        // Bounded: the producer waits for room, batches come in order and never exceed the limit.
+        {
+            sc::manual_executor ex;
+            sc::channel<int> ch( ex, 3 );
+            std::atomic<int> running{1};
+            sc::list<int> out;
+            size_t batches = 0;
+            sc::spawn( ex, produce( ch, 0, 20, running ) );
+            sc::spawn( ex, consume_many( ch, 2, out, batches ) );
+            ex.run();
+            assert( out.size() == 20 and batches >= 10 );
+            auto i{0};
+            for ( auto it = out.begin() ; it != out.end() ; ++it )
+                assert( *it == i++ );
+        }
+
+        // Zero capacity: every value goes from a pusher to a popper.
+        {
+            sc::manual_executor ex;
+            sc::channel<int> ch( ex, 0 );
+            std::atomic<int> running{2}, count{0};
+            std::atomic<long> sum{0};
+            sc::spawn( ex, produce( ch, 0, 10, running ) );
+            sc::spawn( ex, produce( ch, 10, 20, running ) );
+            sc::spawn( ex, consume( ch, sum, count ) );
+            ex.run();
+            assert( count == 20 and sum == 190 );
+        }
+
+        // Values are moved from the pusher to the popper: move-only values go through, others are never copied.
+        for ( size_t capacity : { size_t{0}, size_t{2}, sc::channel<int>::unbounded } )
+            for ( bool batches : { false, true } )
+            {
+                sc::manual_executor ex;
+                sc::channel< std::unique_ptr<int> > owned( ex, capacity );
+                long sum = 0;
+                sc::spawn( ex, receive_moved( owned, batches, sum, []( const std::unique_ptr<int> & p ){ return *p; } ) );
+                sc::spawn( ex, send_moved( owned, 20, []( int i ){ return std::make_unique<int>( i ); } ) );
+                ex.run();
+                assert( sum == 190 );
+
+                sc::channel< Tracked<true> > tracked( ex, capacity );
+                int copies = Tracked<true>::copies;
+                sum = 0;
+                sc::spawn( ex, send_moved( tracked, 20, []( int i ){ return Tracked<true>( i ); } ) );
+                sc::spawn( ex, receive_moved( tracked, batches, sum, []( const Tracked<true> & t ){ return t.value; } ) );
+                ex.run();
+                assert( sum == 190 and Tracked<true>::copies == copies );
+            }
+
+        // Close resumes the waiting poppers in arrival order, and an empty batch limit is rejected.
+        {
+            sc::manual_executor ex;
+            sc::channel<int> ch( ex );
+            std::vector<int> order;
+            for ( auto i{0} ; i < 4 ; ++i )
+                sc::spawn( ex, await_close( ch, i, order ) );
+            ex.run();
+            assert( order.empty() );
+            ch.close();
+            ex.run();
+            assert( ( order == std::vector<int>{ 0, 1, 2, 3 } ) );
+
+            auto thrown{false};
+            try { ch.pop_many( 0 ); }
+            catch ( const std::invalid_argument & ) { thrown = true; }
+            assert( thrown );
+        }
+
+        // Thread pool: several producers and consumers on a small bounded channel.
+        {
+            sc::thread_pool_executor pool( 4 );
+            sc::channel<int> ch( pool, 16 );
+            std::atomic<int> running{4}, count{0};
+            std::atomic<long> sum{0};
+            for ( auto c{0} ; c < 2 ; ++c )
+                sc::spawn( pool, consume( ch, sum, count ) );
+            for ( auto p{0} ; p < 4 ; ++p )
+                sc::spawn( pool, produce( ch, p * 1000, ( p + 1 ) * 1000, running ) );
+            while ( count < 4000 or running > 0 )
+                pool.wait_idle();
+            assert( count == 4000 and sum == 3999L * 4000 / 2 );
+        }
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": allocator and thread_caching_allocator.\n";
+
+        typedef sc::list< long, sc::thread_caching_allocator< long > > cached_list;
+
+        cached_list seq;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            seq.push_back( i );
+        seq.erase( seq.begin(), seq.begin() + 500 );
+        seq.shrink_to_fit();
+        assert( seq.size() == 500 and seq.front() == 500 );
+        cached_list copy( seq );
+        assert( copy == seq );
+        seq.clear();
+        assert( seq.empty() and copy.size() == 500 );
+
+        auto stats = sc::thread_caching_allocator< long >::stats();
+        assert( stats.slabs > 0 and stats.refills >= stats.slabs );
+
+        // Lists built on some threads and destroyed on others, blocks travel through the depot.
+        std::vector< cached_list > lists( 4 );
+        std::vector< std::thread > builders;
+        for ( auto t{0} ; t < 4 ; ++t )
+            builders.emplace_back( [&lists, t]() {
+                for ( auto i{0} ; i < 5000 ; ++i )
+                    lists[t].push_back( t * 5000 + i );
+            } );
+        for ( auto & builder : builders )
+            builder.join();
+        std::thread destroyer( [&lists]() {
+            long sum = 0;
+            for ( auto & list : lists )
+            {
+                for ( auto it = list.begin() ; it != list.end() ; ++it )
+                    sum += *it;
+                list.clear();
+                list.shrink_to_fit();
+            }
+            assert( sum == 19999L * 20000 / 2 );
+        } );
+        destroyer.join();
+        assert( sc::thread_caching_allocator< long >::stats().returns > stats.returns );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": sort() and external_sort().\n";
+
+        // Stable: pairs with equal keys keep their order, iterators follow their elements.
+        sc::list< std::pair< int, int > > pairs;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            pairs.push_back( { ( i * 7919 ) % 13, i } );
+        auto first = pairs.begin();
+        pairs.sort( []( const auto & a, const auto & b ){ return a.first < b.first; } );
+        assert( pairs.size() == 1000 );
+        for ( auto it = pairs.begin() ; std::next( it ) != pairs.end() ; ++it )
+        {
+            auto next = std::next( it );
+            assert( it->first < next->first or ( it->first == next->first and it->second < next->second ) );
+        }
+        assert( first->second == 0 );
+
+        sc::list<int> seq{ 5, 3, 9, 1, 7 };
+        seq.sort();
+        assert( seq == ( sc::list<int>{ 1, 3, 5, 7, 9 } ) );
+
+        // 100k ints in 32 KiB: dozens of runs, merged in several passes.
+        std::vector<int> input;
+        unsigned seed = 12345;
+        for ( auto i{0} ; i < 100000 ; ++i )
+        {
+            seed = seed * 1103515245u + 12345u;
+            input.push_back( int( seed >> 8 ) % 50000 );
+        }
+        sc::external_sorter< int, std::less<int> > sorter( std::less<int>(), 1 << 15 );
+        for ( int value : input )
+            sorter.push( value );
+        assert( sorter.runs() > 10 );
+        std::vector<int> sorted;
+        sorter.finish( std::back_inserter( sorted ) );
+        std::vector<int> expected( input );
+        std::sort( expected.begin(), expected.end() );
+        assert( sorted == expected );
+
+        auto result = sc::external_sort( input.begin(), input.end(), std::greater<int>(), 1 << 15 );
+        assert( result.size() == input.size() and result.front() == expected.back() and result.back() == expected.front() );
+
+        // Fits in the budget, nothing is spilled.
+        auto small = sc::external_sort( input.begin(), input.begin() + 100, std::less<int>(), 1 << 20 );
+        assert( small.size() == 100 and std::is_sorted( small.begin(), small.end() ) );
+
+        bool thrown = false;
+        try {
+            sc::external_sort( input.begin(), input.end(), std::less<int>(), 1 << 12, "/nonexistent/dir" );
+        } catch ( std::runtime_error & ) {
+            thrown = true;
+        }
+        assert( thrown );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": sc::vector.\n";
+
+        // Swapping the container is a one typedef change.
+        assert( containerWorkload< sc::vector<int> >() == containerWorkload< sc::list<int> >() );
+
+        sc::vector<int> seq;
+        assert( seq.empty() and seq.capacity() == 0 );
+        size_t reallocations = 0;
+        for ( auto i{0} ; i < 1000 ; ++i )
+        {
+            size_t old_capacity = seq.capacity();
+            seq.push_back( i );
+            reallocations += seq.capacity() != old_capacity;
+        }
+        assert( seq.size() == 1000 and reallocations <= 10 );
+        assert( seq[999] == 999 and seq.back() == 999 and seq.front() == 0 );
+
+        bool thrown = false;
+        try {
+            seq.at( 1000 );
+        } catch ( std::out_of_range & ) {
+            thrown = true;
+        }
+        assert( thrown );
+
+        // Aliasing: the pushed value lives in the vector being reallocated.
+        seq.shrink_to_fit();
+        assert( seq.capacity() == seq.size() );
+        seq.push_back( seq[10] );
+        assert( seq.back() == 10 );
+        seq.insert( seq.begin(), seq[5] );
+        assert( seq.front() == 5 and seq[1] == 0 );
+
+        sc::vector<int> copy( seq );
+        assert( copy == seq );
+        sc::vector<int> moved( std::move( copy ) );
+        assert( moved == seq and copy.empty() );
+        moved.assign( { 3, 1, 2, 1 } );
+        moved.sort();
+        moved.unique();
+        assert( moved == ( sc::vector<int>{ 1, 2, 3 } ) );
+        moved.resize( 5 );
+        assert( moved.size() == 5 and moved.back() == 0 );
+        assert( sc::erase_if( moved, []( int x ){ return x == 0; } ) == 2 );
+
+        std::istringstream words( "4 5 6" );
+        sc::vector<int> parsed{ std::istream_iterator<int>( words ), std::istream_iterator<int>() };
+        assert( parsed == ( sc::vector<int>{ 4, 5, 6 } ) );
+
+        // Reallocation moves when the move can't throw...
+        sc::vector< Tracked<true> > fast;
+        for ( auto i{0} ; i < 100 ; ++i )
+            fast.emplace_back( i );
+        assert( Tracked<true>::copies == 0 and Tracked<true>::moves > 0 );
+
+        // ...copies otherwise, and a failed copy leaves the vector as it was.
+        sc::vector< Tracked<false> > safe;
+        safe.reserve( 4 );
+        for ( auto i{0} ; i < 4 ; ++i )
+            safe.emplace_back( i );
+        assert( Tracked<false>::moves == 0 );
+        Tracked<false>::copies_left = 2;
+        thrown = false;
+        try {
+            safe.emplace_back( 4 );
+        } catch ( std::runtime_error & ) {
+            thrown = true;
+        }
+        assert( thrown and safe.size() == 4 and safe.capacity() == 4 and safe[3].value == 3 );
+        Tracked<false>::copies_left = -1;
+        safe.emplace_back( 4 );
+        assert( safe.size() == 5 and safe[4].value == 4 and Tracked<false>::moves == 0 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": adaptive_list.\n";
+
+        assert( containerWorkload< sc::adaptive_list<int> >() == containerWorkload< sc::list<int> >() );
+
+        // Build phase: insertions in the middle move it to nodes.
+        sc::adaptive_list<int> seq;
+        for ( auto i{0} ; i < 100 ; ++i )
+            seq.push_back( 2 * i );
+        assert( seq.is_contiguous() );
+        auto middle = seq.end();
+        for ( auto i{0} ; i < 100 ; ++i )
+            middle = seq.insert( seq.end() - 50, 1 );
+        assert( not seq.is_contiguous() and seq.stats().to_linked == 1 );
+        assert( *middle == 1 and seq.size() == 200 );
+
+        // A few reads among the insertions don't move it back.
+        for ( auto i{0} ; i < 10 ; ++i )
+        {
+            seq.insert( seq.end() - 50, 1 );
+            assert( seq[i] == 2 * i );
+        }
+        assert( not seq.is_contiguous() and seq.stats().to_contiguous == 0 );
+
+        // Read phase: indexed scans move it back to an array.
+        long sum = 0;
+        for ( auto round{0} ; round < 3 ; ++round )
+            for ( size_t i{0} ; i < seq.size() ; ++i )
+                sum += seq[i];
+        assert( seq.is_contiguous() and seq.stats().to_contiguous == 1 and seq.stats().to_linked == 1 );
+        assert( sum == 3 * ( 2 * 99 * 100 / 2 + 110 ) );
+        assert( seq.stats().elements_moved == 116 + 210 ); // linked after 16 insertions, 2 pressure each
+        assert( seq.stats().indexed_ops == 10 + 3 * 210 and seq.stats().structural_ops == 110 );
+
+        // Same contents whatever the representations.
+        sc::adaptive_list<int> copy( seq );
+        copy.make_linked();
+        assert( copy == seq and not copy.is_contiguous() );
+        auto after = seq.erase( seq.begin(), seq.end() );
+        assert( after == seq.end() and seq.empty() );
+
+        // Small lists stay contiguous.
+        sc::adaptive_list<int> small{ 1, 2, 3 };
+        for ( auto i{0} ; i < 100 ; ++i )
+        {
+            small.push_front( i );
+            small.pop_back();
+        }
+        assert( small.is_contiguous() and small.stats().to_linked == 0 );
+
+        // Conversions and moves of the whole list move the elements, so move-only ones work.
+        sc::adaptive_list< std::unique_ptr<int> > owners;
+        for ( auto i{0} ; i < 5 ; ++i )
+            owners.push_back( std::make_unique<int>( i ) );
+        owners.make_linked();
+        owners.push_back( std::make_unique<int>( 5 ) );
+        sc::adaptive_list< std::unique_ptr<int> > taken( std::move( owners ) );
+        assert( owners.empty() and taken.size() == 6 and not taken.is_contiguous() );
+        owners = std::move( taken );
+        owners.make_contiguous();
+        assert( taken.empty() and *owners.front() == 0 and *owners.back() == 5 );
+
+        sc::list<int> nodes{ 1, 2, 3 };
+        sc::list<int> moved( std::move( nodes ) );
+        assert( nodes.empty() and moved == ( sc::list<int>{ 1, 2, 3 } ) );
+        nodes.push_back( 4 );
+        nodes = std::move( moved );
+        assert( moved.empty() and nodes == ( sc::list<int>{ 1, 2, 3 } ) );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": reverse(), rotate(), partition() and stable_partition().\n";
+
+        sc::list<int> seq{ 1, 2, 3, 4, 5, 6 };
+        auto three = seq.begin() + 2;
+        seq.reverse();
+        assert( seq == ( sc::list<int>{ 6, 5, 4, 3, 2, 1 } ) );
+        assert( *three == 3 and *std::next( three ) == 2 );
+        assert( std::prev( seq.end() ) == std::next( three, 2 ) );
+
+        auto old_first = seq.rotate( three );
+        assert( seq == ( sc::list<int>{ 3, 2, 1, 6, 5, 4 } ) );
+        assert( *old_first == 6 and seq.begin() == three );
+        assert( seq.rotate( seq.begin() ) == seq.end() and seq.rotate( seq.end() ) == seq.begin() );
+
+        auto odd = seq.stable_partition( []( int x ){ return x % 2 == 0; } );
+        assert( seq == ( sc::list<int>{ 2, 6, 4, 3, 1, 5 } ) );
+        assert( *odd == 3 and *three == 3 );
+        assert( seq.partition( []( int x ){ return x > 0; } ) == seq.end() );
+        assert( seq.partition( []( int x ){ return x > 10; } ) == seq.begin() );
+#ifdef SC_LIST_ORDER_LABELS
+        assert( seq.begin() < odd and odd < std::prev( seq.end() ) and three < odd + 1 );
+#endif
+
+        sc::list<int> single{ 7 };
+        single.reverse();
+        assert( single == ( sc::list<int>{ 7 } ) and single.back() == 7 );
+
+        // A throwing predicate keeps every element.
+        bool thrown = false;
+        try {
+            seq.stable_partition( []( int x ){ if ( x == 1 ) throw std::runtime_error( "pred" ); return x > 3; } );
+        } catch ( std::runtime_error & ) {
+            thrown = true;
+        }
+        assert( thrown and seq.size() == 6 and seq.back() == 3 );
+
+        // Only pointers move: no element is copied or moved.
+        sc::list< Tracked<true> > tracked;
+        for ( auto i{0} ; i < 100 ; ++i )
+            tracked.push_back( Tracked<true>( i ) );
+        int copies = Tracked<true>::copies;
+        int moves = Tracked<true>::moves;
+        tracked.reverse();
+        tracked.rotate( tracked.begin() + 30 );
+        tracked.stable_partition( []( const Tracked<true> & t ){ return t.value % 3 == 0; } );
+        tracked.partition( []( const Tracked<true> & t ){ return t.value < 50; } );
+        assert( Tracked<true>::copies == copies and Tracked<true>::moves == moves );
+        assert( tracked.size() == 100 and tracked.front().value == 48 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": forward_list.\n";
+
+        // Queue use: push_back() through the tail pointer, pop_front().
+        sc::forward_list<int> queue;
+        for ( auto i{0} ; i < 10 ; ++i )
+            queue.push_back( i );
+        for ( auto i{0} ; i < 5 ; ++i )
+            queue.pop_front();
+        queue.push_back( 10 );
+        assert( queue == ( sc::forward_list<int>{ 5, 6, 7, 8, 9, 10 } ) );
+        assert( queue.front() == 5 and queue.back() == 10 and queue.size() == 6 );
+        assert( queue.capacity() == 10 );
+        while ( not queue.empty() )
+            queue.pop_front();
+        queue.push_back( 1 );
+        assert( queue.front() == 1 and queue.back() == 1 and queue.capacity() == 10 );
+
+        sc::forward_list<int> seq{ 1, 2, 4 };
+        seq.push_front( 0 );
+        auto three = seq.insert_after( std::next( seq.begin(), 2 ), 3 );
+        assert( *three == 3 and seq == ( sc::forward_list<int>{ 0, 1, 2, 3, 4 } ) );
+        assert( *seq.erase_after( seq.begin() ) == 2 );
+        seq.insert_after( seq.before_end(), { 5, 6 } );
+        assert( seq == ( sc::forward_list<int>{ 0, 2, 3, 4, 5, 6 } ) and seq.back() == 6 );
+        assert( seq.erase_after( three, seq.end() ) == seq.end() and seq.back() == 3 );
+        seq.push_back( 7 );
+        assert( seq == ( sc::forward_list<int>{ 0, 2, 3, 7 } ) );
+
+        // Splicing relinks the nodes, iterators follow them.
+        sc::forward_list<int> other{ 8, 9 };
+        auto eight = other.begin();
+        seq.splice_after( seq.before_end(), other );
+        assert( other.empty() and seq.size() == 6 and seq.back() == 9 and *eight == 8 );
+        other.push_back( 10 );
+        assert( other.front() == 10 and other.back() == 10 );
+        seq.splice_after( seq.before_begin(), seq, eight );
+        assert( seq == ( sc::forward_list<int>{ 9, 0, 2, 3, 7, 8 } ) and seq.back() == 8 );
+        seq.splice_after( seq.before_end(), other, other.before_begin() );
+        assert( seq.back() == 10 and other.empty() and other.before_end() == other.before_begin() );
+
+        assert( sc::erase_if( seq, []( int x ){ return x % 2 == 0; } ) == 4 );
+        assert( seq == ( sc::forward_list<int>{ 9, 3, 7 } ) and seq.back() == 7 );
+
+        // Shares the thread caching allocator with sc::list.
+        sc::forward_list< long, sc::thread_caching_allocator< long > > cached;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            cached.push_back( i );
+        sc::forward_list< long, sc::thread_caching_allocator< long > > copy( cached );
+        assert( copy == cached and copy.back() == 999 );
+
+        // Erased and cleared elements are destroyed at once, moves take the nodes.
+        {
+            sc::forward_list< Counted > counted;
+            for ( auto i{0} ; i < 6 ; ++i )
+                counted.push_back( Counted( i ) );
+            counted.pop_front();
+            counted.erase_after( counted.begin() );
+            assert( Counted::alive == 4 );
+            counted.remove_if( []( const Counted & c ){ return c.value == 3; } );
+            assert( Counted::alive == 3 );
+            sc::forward_list< Counted > moved( std::move( counted ) );
+            assert( counted.empty() and moved.size() == 3 and Counted::alive == 3 );
+            counted.push_back( Counted( 9 ) );
+            counted = std::move( moved );
+            assert( moved.empty() and counted.size() == 3 and counted.back().value == 5 and Counted::alive == 3 );
+            counted.clear();
+            assert( Counted::alive == 0 and counted.capacity() >= 3 );
+        }
+        assert( Counted::alive == 0 );
+
+        // Between allocators that differ, move assignment moves the elements instead of the nodes.
+        {
+            typedef sc::forward_list< std::string, TaggedAllocator< std::string > > tagged_list;
+            tagged_list left( TaggedAllocator< std::string >( 1 ) );
+            tagged_list right( TaggedAllocator< std::string >( 2 ) );
+            right.push_back( "a" );
+            right.push_back( "b" );
+            left = std::move( right );
+            assert( right.empty() and left.size() == 2 and left.back() == "b" );
+            tagged_list same( TaggedAllocator< std::string >( 1 ) );
+            same = std::move( left );
+            assert( left.empty() and same.front() == "a" );
+        }
+        assert( TaggedAllocator<char>::owners.empty() );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": node layouts.\n";
+
+        assert( layoutWorkload< sc::data_first >() == "dbadba6" );
+        assert( layoutWorkload< sc::links_first >() == layoutWorkload< sc::data_first >() );
+        assert( layoutWorkload< sc::cache_aligned >() == layoutWorkload< sc::data_first >() );
+        assert( layoutWorkload< sc::out_of_line >() == layoutWorkload< sc::data_first >() );
+
+        typedef std::array< char, 200 > big;
+        assert( ( sc::list< big >::node_bytes >= sizeof( big ) + 2 * sizeof( void * ) ) );
+        assert( ( sc::list< big, std::allocator< big >, sc::links_first >::node_bytes == sc::list< big >::node_bytes ) );
+        assert( ( sc::list< big, std::allocator< big >, sc::cache_aligned >::node_bytes % 64 == 0 ) );
+        assert( ( sc::list< big, std::allocator< big >, sc::out_of_line >::node_bytes <= 4 * sizeof( void * ) ) ); // links, label, payload
+        assert( ( sc::list< int, std::allocator< int >, sc::out_of_line >::node_bytes == sc::list< big, std::allocator< big >, sc::out_of_line >::node_bytes ) );
+
+        // Nodes start on their own cache lines, the links at the start of the node.
+        sc::list< big, std::allocator< big >, sc::cache_aligned > aligned( 10 );
+        for ( auto it = aligned.begin() ; it != aligned.end() ; ++it )
+            assert( ( reinterpret_cast< std::uintptr_t >( &*it ) - 2 * sizeof( void * ) ) % 64 < 16 );
+
+        // Elements apart from the nodes, with the thread caching allocator too.
+        sc::list< big, sc::thread_caching_allocator< big >, sc::out_of_line > apart;
+        big filled;
+        filled.fill( 'x' );
+        for ( auto i{0} ; i < 100 ; ++i )
+            apart.push_back( filled );
+        apart.erase( apart.begin(), apart.begin() + 50 );
+        apart.shrink_to_fit();
+        assert( apart.size() == 50 and apart.front()[199] == 'x' );
+
+        // Threads take slots from their own caches, frees may come from another thread or after main() returns.
+        typedef sc::list< big, std::allocator< big >, sc::out_of_line > apart_list;
+        std::vector< apart_list > built( 4 );
+        std::vector< std::thread > builders;
+        for ( auto & seq : built )
+            builders.emplace_back( [&seq, &filled]() {
+                for ( auto i{0} ; i < 500 ; ++i )
+                    seq.push_back( filled );
+            } );
+        for ( auto & builder : builders )
+            builder.join();
+        for ( auto & seq : built )
+            assert( seq.size() == 500 and seq.back()[0] == 'x' );
+        built.clear();
+        static apart_list late( 300 );
+        assert( late.size() == 300 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": format_to(), parse() and operator>>.\n";
+
+        sc::list<int> seq{ 0, -7, 42, 2147483647, -2147483647 - 1 };
+        std::string text;
+        sc::format_to( text, seq );
+        std::ostringstream os;
+        os << seq;
+        assert( text == os.str() and text == "[ 0 -7 42 2147483647 -2147483648 ]" );
+        assert( sc::parse<int>( text ) == seq );
+
+        // The buffer is appended to, reuse it by clearing it.
+        sc::format_to( text, sc::list<int>{} );
+        assert( text.substr( text.size() - 3 ) == "[ ]" );
+        text.clear();
+        assert( sc::parse<int>( " [ ]\n" ).empty() );
+
+        sc::list<double> reals{ 0.1, -2.5e-300, 1e300, 3.0 };
+        sc::format_to( text, reals );
+        assert( sc::parse<double>( text ) == reals );
+
+        char small[8];
+        auto result = sc::format_to( small, small + sizeof( small ), seq );
+        assert( result.ec == std::errc::value_too_large );
+        result = sc::format_to( small, small + sizeof( small ), sc::list<int>{ 1, 2 } );
+        assert( result.ec == std::errc() and std::string( small, result.ptr ) == "[ 1 2 ]" );
+
+        for ( const char * bad : { "", "1 2", "[ 1 2", "[ 1x ]", "[ 1 ] 2", "[ 99999999999 ]" } )
+        {
+            bool thrown = false;
+            try {
+                sc::parse<int>( bad );
+            } catch ( std::invalid_argument & ) {
+                thrown = true;
+            }
+            assert( thrown );
+        }
+
+        // parse( text, seq ) appends and tells where the list ended, or leaves seq as it was.
+        sc::list<long> longs{ 1 };
+        assert( sc::parse( "[ 2 3 ] [ 4 ]", longs ) == 7 );
+        assert( longs == ( sc::list<long>{ 1, 2, 3 } ) );
+        bool thrown = false;
+        try {
+            sc::parse( "[ 4 5 x ]", longs );
+        } catch ( std::invalid_argument & ) {
+            thrown = true;
+        }
+        assert( thrown and longs == ( sc::list<long>{ 1, 2, 3 } ) );
+
+        // A buffer with room left is written in place, it only grows when short.
+        text.clear();
+        sc::format_to( text, seq );
+        const char * data = text.data();
+        auto capacity = text.capacity();
+        text.clear();
+        sc::format_to( text, seq );
+        assert( text.data() == data and text.capacity() == capacity and text == os.str() );
+        sc::list<int> many;
+        for ( auto i{0} ; i < 1000 ; ++i )
+            many.push_back( -i * 1000003 );
+        text.clear();
+        sc::format_to( text, many );
+        assert( sc::parse<int>( text ) == many );
+
+        std::istringstream is( "[ 1 2 3 ]\n[ -4 ] [ oops ]" );
+        sc::list<int> read{ 9 };
+        is >> read;
+        assert( is and read == ( sc::list<int>{ 1, 2, 3 } ) );
+        is >> read;
+        assert( is and read == ( sc::list<int>{ -4 } ) );
+        is >> read;
+        assert( is.fail() and read.empty() );
+        std::istringstream cut( "[ 4 5" );
+        read = { 1, 2, 3 };
+        cut >> read;
+        assert( cut.fail() and read.empty() );
+        std::istringstream none( "" );
+        read = { 1, 2, 3 };
+        none >> read;
+        assert( none.fail() and read.empty() );
+        std::string shortest;
+        sc::format_to( shortest, sc::list<double>{ 1.23456789 } );
+        assert( shortest == "[ 1.23456789 ]" );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": perf_scope.\n";
+
+        // The counters may be refused (perf_event_paranoid, containers, no PMU): then nothing counts or prints.
+        sc::perf_scope scope;
+        sc::list<int> seq;
+        for ( int i = 0 ; i < 10000 ; ++i )
+            seq.push_back( i );
+        long total = 0;
+        for ( int x : seq )
+            total += x;
+        assert( total == 49995000L );
+
+        sc::perf_counts counts = scope.read();
+        assert( counts.any() or not scope.error().empty() );
+        if ( counts.valid[sc::perf_counts::instructions] )
+            assert( counts.value[sc::perf_counts::instructions] >= 20000 );
+
+        std::ostringstream os;
+        sc::perf_scope::report( os, "walk", counts, seq.size() );
+        assert( os.str().empty() != counts.any() );
+        if ( counts.any() )
+            assert( os.str().find( "per element" ) != std::string::npos );
+
+        sc::perf_scope::report( os, "none", sc::perf_counts{}, 1 );
+        assert( os.str().find( "none" ) == std::string::npos );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": list_pool.\n";
+
+        // Adjacency lists of a ring of 1000 vertices.
+        sc::list_pool<int> pool;
+        std::vector<sc::list_pool<int>::handle> adj;
+        for ( int v = 0 ; v < 1000 ; ++v )
+            adj.push_back( pool.create() );
+        for ( int v = 0 ; v < 1000 ; ++v )
+        {
+            pool.push_back( adj[v], ( v + 1 ) % 1000 );
+            pool.push_front( adj[v], ( v + 999 ) % 1000 );
+        }
+        assert( pool.list_count() == 1000 and pool.node_count() == 2000 );
+        assert( pool.size( adj[0] ) == 2 and pool.front( adj[0] ) == 999 and pool.back( adj[0] ) == 1 );
+        long total = 0;
+        for ( int v = 0 ; v < 1000 ; ++v )
+            for ( int w : pool.range( adj[v] ) )
+                total += w;
+        assert( total == 2 * 499500L );
+
+        // splice() is O(1) and empties the source.
+        pool.splice( adj[0], adj[1] );
+        assert( pool.empty( adj[1] ) and pool.size( adj[0] ) == 4 and pool.back( adj[0] ) == 2 );
+        pool.splice( adj[1], adj[0] );
+        assert( pool.empty( adj[0] ) and pool.size( adj[1] ) == 4 );
+        pool.splice_front( adj[0], adj[1] );
+        assert( pool.size( adj[0] ) == 1 and pool.front( adj[0] ) == 999 and pool.front( adj[1] ) == 1 );
+        pool.splice_front( adj[1], adj[1] );
+        assert( pool.front( adj[1] ) == 0 and pool.back( adj[1] ) == 1 );
+        pool.pop_front( adj[1] );
+        pool.pop_front( adj[1] );
+        pool.pop_front( adj[1] );
+        pool.pop_front( adj[1] );
+        assert( pool.empty( adj[1] ) and pool.begin( adj[1] ) == pool.end( adj[1] ) );
+        pool.push_back( adj[1], 7 );
+        assert( pool.front( adj[1] ) == 7 and pool.back( adj[1] ) == 7 );
+
+        // Freed nodes and handles are reused before the pool grows.
+        size_t capacity = pool.capacity();
+        pool.destroy( adj[2] );
+        auto again = pool.create();
+        assert( again == adj[2] and pool.empty( again ) );
+        for ( int i = 0 ; i < 100 ; ++i )
+        {
+            pool.push_back( again, i );
+            pool.clear( again );
+        }
+        assert( pool.capacity() == capacity );
+        std::fill( pool.begin( adj[3] ), pool.end( adj[3] ), 5 );
+        const auto & view = pool;
+        assert( std::count( view.begin( adj[3] ), view.end( adj[3] ), 5 ) == 2 );
+
+        // Bulk clear drops every list and keeps the chunks.
+        pool.clear();
+        assert( pool.list_count() == 0 and pool.node_count() == 0 and pool.capacity() == capacity );
+        auto h = pool.create();
+        assert( h == 0 );
+        pool.emplace_back( h, 3 );
+        sc::list_pool<int> moved( std::move( pool ) );
+        assert( moved.front( h ) == 3 and pool.list_count() == 0 and pool.capacity() == 0 );
+
+        // Elements with a destructor are destroyed by pop_front(), clear(), destroy() and the destructor.
+        sc::list_pool<std::string> words;
+        auto a = words.create(), b = words.create();
+        for ( int i = 0 ; i < 50 ; ++i )
+        {
+            words.push_back( a, std::string( 40, char( 'a' + i % 26 ) ) );
+            words.emplace_back( b, 30, 'z' );
+        }
+        words.pop_front( a );
+        assert( words.front( a ) == std::string( 40, 'b' ) and words.begin( a )->size() == 40 );
+        words.splice( a, b );
+        assert( words.size( a ) == 99 and words.back( a ) == std::string( 30, 'z' ) );
+        words.destroy( a );
+        words.push_back( b, "left for the destructor" );
+        auto c = words.create();
+        words.push_back( c, "cleared in bulk" );
+        words.clear();
+        words.push_back( words.create(), "left for the destructor" );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": compressed_list.\n";
+
+        // Sorted IDs with small gaps take about a byte each.
+        sc::compressed_list<uint32_t> ids;
+        sc::list<uint32_t> plain;
+        uint32_t id = 1000;
+        for ( int i = 0 ; i < 10000 ; ++i )
+        {
+            id += 1 + i % 50;
+            ids.push_back( id );
+            plain.push_back( id );
+        }
+        assert( ids.size() == 10000 and ids.front() == 1001 and ids.back() == id );
+        assert( std::equal( ids.begin(), ids.end(), plain.begin(), plain.end() ) );
+        assert( ids.memory_bytes() * 10 < plain.size() * sc::list<uint32_t>::node_bytes );
+        uint64_t total = 0, expected = 0;
+        ids.for_each( [&total]( uint32_t x ){ total += x; } );
+        for ( uint32_t x : plain )
+            expected += x;
+        assert( total == expected );
+
+        // Backward walks decode the deltas from their end.
+        auto back = plain.end();
+        for ( auto it = ids.end() ; it != ids.begin() ; )
+            assert( *--it == *--back );
+
+        // Any step fits, wrap-around and negative ones included.
+        sc::compressed_list<int64_t> wide{ 0, -1, INT64_MAX, INT64_MIN, 5, 5, -300, 1LL << 40 };
+        std::ostringstream os;
+        os << wide;
+        assert( os.str() == "[ 0 -1 9223372036854775807 -9223372036854775808 5 5 -300 1099511627776 ]" );
+        sc::compressed_list<uint8_t> bytes{ 255, 0, 128, 7 };
+        assert( *std::prev( bytes.end() ) == 7 and *++bytes.begin() == 0 );
+
+        // insert() and erase() re-encode a block, splitting it when it overflows.
+        sc::compressed_list<int> seq;
+        std::vector<int> model;
+        std::mt19937 gen( 5 );
+        for ( int i = 0 ; i < 3000 ; ++i )
+        {
+            size_t at = model.empty() ? 0 : gen() % ( model.size() + 1 );
+            int value = static_cast<int>( gen() % 2 ? gen() % 100 : gen() );
+            auto pos = std::next( seq.begin(), at );
+            auto inserted = seq.insert( pos, value );
+            model.insert( model.begin() + at, value );
+            assert( *inserted == value and std::distance( seq.begin(), inserted ) == static_cast<long>( at ) );
+
+            if ( i % 3 == 0 )
+            {
+                at = gen() % model.size();
+                auto next = seq.erase( std::next( seq.begin(), at ) );
+                model.erase( model.begin() + at );
+                assert( std::distance( seq.begin(), next ) == static_cast<long>( at ) );
+            }
+        }
+        assert( seq.size() == model.size() and std::equal( seq.begin(), seq.end(), model.begin(), model.end() ) );
+        assert( seq.block_count() > 1 );
+
+        sc::compressed_list<int> copy( seq );
+        assert( copy == seq );
+        copy.push_front( -5 );
+        copy.pop_back();
+        assert( copy.front() == -5 and copy.back() == model[model.size() - 2] and copy != seq );
+        assert( sc::erase_if( copy, []( int x ){ return x < 0; } ) > 0 );
+        assert( std::find_if( copy.begin(), copy.end(), []( int x ){ return x < 0; } ) == copy.end() );
+        seq.erase( seq.begin(), seq.end() );
+        assert( seq.empty() and seq.block_count() == 0 and seq.begin() == seq.end() );
+        seq = std::move( copy );
+        assert( copy.empty() and not seq.empty() );
+        seq.clear();
+        assert( seq.empty() and seq.memory_bytes() == sizeof( seq ) );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": assign() and operator= over existing nodes.\n";
+
+        struct point { int x; double y; bool operator==( const point & ) const = default; };
+        static_assert( std::is_trivially_copyable< point >::value );
+
+        sc::list<point> seq{ { 1, 1.5 }, { 2, 2.5 }, { 3, 3.5 } };
+        seq.assign( seq.front() );
+        for ( const point & p : seq )
+            assert( p == ( point{ 1, 1.5 } ) );
+        seq.assign( { point{ 4, 0.0 }, point{ 5, 0.0 } } );
+        assert( seq.front().x == 4 and seq.back() == ( point{ 1, 1.5 } ) );
+        std::vector<point> source{ { 7, 7.0 }, { 8, 8.0 }, { 9, 9.0 }, { 10, 10.0 } };
+        seq.assign( source.begin(), source.end() );
+        assert( seq.size() == 3 and seq.back().x == 9 );
+
+        // Shrinking keeps the nodes as spares, growing again reuses them.
+        sc::list<point> big( source.begin(), source.end() );
+        sc::list<point> small{ { 0, 0.0 } };
+        seq = big;
+        assert( seq.size() == 4 and seq.back().x == 10 and seq.capacity() == 4 );
+        seq = small;
+        assert( seq.size() == 1 and seq.front().x == 0 and seq.capacity() == 4 );
+        seq = big;
+        assert( seq.size() == 4 and seq.capacity() == 4 and std::equal( seq.begin(), seq.end(), source.begin() ) );
+        seq = { { 3, 3.0 }, { 2, 2.0 } };
+        assert( seq.size() == 2 and seq.capacity() == 4 and seq.back().x == 2 );
+        const sc::list<point> & same = seq;
+        seq = same;
+        assert( seq.size() == 2 and seq.front().x == 3 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": removed elements are destroyed, spare nodes hold none.\n";
+
+        checkRemovedDestroyed< sc::data_first >();
+        checkRemovedDestroyed< sc::links_first >();
+        checkRemovedDestroyed< sc::cache_aligned >();
+        checkRemovedDestroyed< sc::out_of_line >();
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": move assignment between allocators.\n";
+
+        checkMoveAssignAllocators< sc::list< std::string, TaggedAllocator< std::string > > >( false );
+        checkMoveAssignAllocators< sc::list< std::string, TaggedAllocator< std::string, true > > >( true );
+        checkMoveAssignAllocators< sc::vector< std::string, TaggedAllocator< std::string > > >( false );
+        checkMoveAssignAllocators< sc::vector< std::string, TaggedAllocator< std::string, true > > >( true );
+
+        // Within one list splice() needs nothing from the allocator.
+        sc::list< std::string, TaggedAllocator< std::string > > seq( TaggedAllocator< std::string >( 1 ) );
+        seq.push_back( "a" );
+        seq.push_back( "b" );
+        seq.splice( seq.begin(), seq, seq.begin() + 1 );
+        assert( seq.front() == "b" );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
+    {
+        std::cout << ">>> Unit teste #" << ++n_unit << ": snapshot().\n";
+
+        sc::snapshot_list<int> seq;
+        for ( auto i{1} ; i <= 5 ; ++i )
+            seq.push_back( i );
+
+        // The view keeps seeing the list as it was when it was taken.
+        {
+            auto view = seq.snapshot();
+            seq.erase( seq.begin() );
+            seq.push_back( 6 );
+            seq.insert( seq.begin(), 0 );
+
+            auto i{1};
+            for ( auto it = view.begin() ; it != view.end() ; ++it )
+                assert( *it == i++ );
+            assert( view.size() == 5 );
+
+            auto latest = seq.snapshot();
+            sc::list<int> expected{ 0, 2, 3, 4, 5, 6 };
+            auto e = expected.begin();
+            for ( auto it = latest.begin() ; it != latest.end() ; ++it, ++e )
+                assert( *it == *e );
+            assert( latest.size() == 6 );
+        }
+        assert( seq.size() == 6 );
+        seq.pop_front();
+        seq.reclaim();
+
+        // Readers always see a window of consecutive values while the writer slides it.
+        std::thread writer( [&seq]() {
+            for ( auto i{7} ; i < 20000 ; ++i )
+            {
+                seq.push_back( i );
+                seq.pop_front();
+            }
+        } );
+        for ( auto round{0} ; round < 200 ; ++round )
+        {
+            auto view = seq.snapshot();
+            auto it = view.begin();
+            auto previous = *it;
+            auto count{1};
+            for ( ++it ; it != view.end() ; ++it, ++count )
+            {
+                assert( *it == previous + 1 );
+                previous = *it;
+            }
+            assert( count == 5 or count == 6 );
+        }
+        writer.join();
+        assert( seq.size() == 5 );
+        assert( seq.front() == 19995 );
+        assert( seq.back() == 19999 );
+
+        std::cout << ">>> Passed!\n\n";
+    }
+
     return 0;
 }
\ No newline at end of file